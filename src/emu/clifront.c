@@ -118,17 +118,23 @@ int cli_execute(int argc, char **argv, const options_entry *osd_options)
 	const char *gamename_option;
 	const game_driver *driver;
 	int result = MAMERR_FATALERROR;
+	int parseerr;
 	astring gamename;
 	astring exename;
 
 	try
 	{
-		/* initialize the options manager and add the CLI-specific options */
-		options = mame_options_init(osd_options);
-		options_add_entries(options, cli_options);
+		{
+			startup_trace_scope trace("options", "cli options");
+
+			/* initialize the options manager and add the CLI-specific options */
+			options = mame_options_init(osd_options);
+			options_add_entries(options, cli_options);
 
-		/* parse the command line first; if we fail here, we're screwed */
-		if (options_parse_command_line(options, argc, argv, OPTION_PRIORITY_CMDLINE))
+			/* parse the command line first; if we fail here, we're screwed */
+			parseerr = options_parse_command_line(options, argc, argv, OPTION_PRIORITY_CMDLINE);
+		}
+		if (parseerr)
 		{
 			result = MAMERR_INVALID_CONFIG;
 			goto error;
@@ -143,7 +149,10 @@ int cli_execute(int argc, char **argv, const options_entry *osd_options)
 		/* find out what game we might be referring to */
 		gamename_option = options_get_string(options, OPTION_GAMENAME);
 		core_filename_extract_base(&gamename, gamename_option, TRUE);
-		driver = driver_get_name(gamename);
+		{
+			startup_trace_scope trace("driver", "driver_get_name");
+			driver = driver_get_name(gamename);
+		}
 
 		/* execute any commands specified */
 		result = execute_commands(options, exename, driver);
@@ -149,6 +149,7 @@ void device_list::start_all()
 			{
 				try
 				{
+					startup_trace_scope trace("device", device->tag());
 					device->start();
 					numstarted++;
 				}
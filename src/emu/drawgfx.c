@@ -13,6 +13,16 @@
 #include "drawgfxm.h"
 
 
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define GFX_CACHE_THRESHOLD		(8 * 1024 * 1024)	/* decoded size above which codes are cached */
+#define GFX_CACHE_BYTES			(4 * 1024 * 1024)	/* size of the decode cache */
+#define GFX_CACHE_MIN_SLOTS		1024
+
+
+
 /***************************************************************************
     GLOBAL VARIABLES
 ***************************************************************************/
@@ -207,7 +217,8 @@ void gfx_init(running_machine *machine)
 		glcopy.height = height;
 		glcopy.total = total;
 
-		/* allocate the graphics */
+		/* allocate the graphics; codes decode lazily, so that cost lands in the first frames */
+		startup_trace_scope trace("gfx", (gfxdecode->memory_region != NULL) ? gfxdecode->memory_region : "ram");
 		machine->gfx[curgfx] = gfx_element_alloc(machine, &glcopy, (region_base != NULL) ? region_base + gfxdecode->start : NULL, gfxdecode->total_color_codes, gfxdecode->color_codes_start);
 	}
 }
@@ -310,8 +321,25 @@ gfx_element *gfx_element_alloc(running_machine *machine, const gfx_layout *gl, c
 		gfx->line_modulo = gfx->origwidth;
 		gfx->char_modulo = gfx->line_modulo * gfx->origheight;
 
+		/* large sets only keep a bounded number of decoded codes around */
+		if ((UINT64)gfx->total_elements * gfx->char_modulo > GFX_CACHE_THRESHOLD)
+		{
+			gfx_cache *cache = auto_alloc_clear(machine, gfx_cache);
+
+			cache->slots = MAX(GFX_CACHE_BYTES / gfx->char_modulo, GFX_CACHE_MIN_SLOTS);
+			cache->slot = auto_alloc_array(machine, UINT32, gfx->total_elements);
+			cache->code = auto_alloc_array(machine, UINT32, cache->slots);
+			cache->referenced = auto_alloc_array_clear(machine, UINT8, cache->slots);
+			memset(cache->slot, 0xff, gfx->total_elements * sizeof(*cache->slot));
+			memset(cache->code, 0xff, cache->slots * sizeof(*cache->code));
+
+			gfx->cache = cache;
+			gfx->gfxdata = auto_alloc_array(machine, UINT8, cache->slots * gfx->char_modulo);
+		}
+
 		/* allocate memory for the data */
-		gfx->gfxdata = auto_alloc_array(machine, UINT8, gfx->total_elements * gfx->char_modulo);
+		else
+			gfx->gfxdata = auto_alloc_array(machine, UINT8, gfx->total_elements * gfx->char_modulo);
 	}
 
 	return gfx;
@@ -345,6 +373,13 @@ void gfx_element_free(gfx_element *gfx)
 	auto_free(gfx->machine, gfx->pen_usage);
 	auto_free(gfx->machine, gfx->dirty);
 	auto_free(gfx->machine, gfx->gfxdata);
+	if (gfx->cache != NULL)
+	{
+		auto_free(gfx->machine, gfx->cache->slot);
+		auto_free(gfx->machine, gfx->cache->code);
+		auto_free(gfx->machine, gfx->cache->referenced);
+		auto_free(gfx->machine, gfx->cache);
+	}
 	auto_free(gfx->machine, gfx);
 }
 
@@ -381,19 +416,59 @@ void gfx_element_build_temporary(gfx_element *gfx, running_machine *machine, UIN
 	gfx->srcdata = base;
 	gfx->dirty = &not_dirty;
 	gfx->dirtyseq = 0;
+	gfx->cache = NULL;
 
 	gfx->machine = machine;
 }
 
 
+/*-------------------------------------------------
+    cache_claim_slot - return the buffer a code
+    decodes into, recycling the least recently
+    used cache slot if it has none
+-------------------------------------------------*/
+
+static UINT8 *cache_claim_slot(const gfx_element *gfx, UINT32 code)
+{
+	gfx_cache *cache = gfx->cache;
+	UINT32 slot;
+
+	/* uncached elements decode in place */
+	if (cache == NULL)
+		return gfx->gfxdata + code * gfx->char_modulo;
+
+	/* reuse our slot if we still have one */
+	slot = cache->slot[code];
+	if (slot == GFX_CACHE_EMPTY)
+	{
+		/* advance the clock hand past recently referenced slots */
+		while (cache->referenced[cache->hand])
+		{
+			cache->referenced[cache->hand] = 0;
+			if (++cache->hand == cache->slots)
+				cache->hand = 0;
+		}
+		slot = cache->hand;
+		if (++cache->hand == cache->slots)
+			cache->hand = 0;
+
+		/* evict the previous owner; its pen usage stays valid */
+		if (cache->code[slot] != GFX_CACHE_EMPTY)
+			cache->slot[cache->code[slot]] = GFX_CACHE_EMPTY;
+		cache->code[slot] = code;
+		cache->slot[code] = slot;
+	}
+	return gfx->gfxdata + slot * gfx->char_modulo;
+}
+
+
 /*-------------------------------------------------
     calc_penusage - calculate the pen usage for
     a given graphics tile
 -------------------------------------------------*/
 
-static void calc_penusage(const gfx_element *gfx, UINT32 code)
+static void calc_penusage(const gfx_element *gfx, UINT32 code, const UINT8 *dp)
 {
-	const UINT8 *dp = gfx->gfxdata + code * gfx->char_modulo;
 	UINT32 usage = 0;
 	int x, y;
 
@@ -443,7 +518,8 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 	const UINT32 *poffset = gl->planeoffset;
 	const UINT32 *xoffset = gl->extxoffs ? gl->extxoffs : gl->xoffset;
 	const UINT32 *yoffset = gl->extyoffs ? gl->extyoffs : gl->yoffset;
-	UINT8 *dp = gfx->gfxdata + code * gfx->char_modulo;
+	UINT8 *base = cache_claim_slot(gfx, code);
+	UINT8 *dp = base;
 	int plane, x, y;
 
 	if (!israw)
@@ -463,7 +539,7 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 				{
 					int yoffs = planeoffs + yoffset[y];
 
-					dp = gfx->gfxdata + code * gfx->char_modulo + y * gfx->line_modulo;
+					dp = base + y * gfx->line_modulo;
 					for (x = 0; x < gfx->origwidth; x += 2)
 					{
 						if (readbit(src, yoffs + xoffset[x + 0]))
@@ -486,7 +562,7 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 				{
 					int yoffs = planeoffs + yoffset[y];
 
-					dp = gfx->gfxdata + code * gfx->char_modulo + y * gfx->line_modulo;
+					dp = base + y * gfx->line_modulo;
 					for (x = 0; x < gfx->origwidth; x++)
 						if (readbit(src, yoffs + xoffset[x]))
 							dp[x] |= planebit;
@@ -495,7 +571,7 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 		}
 	}
 	/* compute pen usage */
-	calc_penusage(gfx, code);
+	calc_penusage(gfx, code, base);
 
 	/* no longer dirty */
 	gfx->dirty[code] = 0;
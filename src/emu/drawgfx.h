@@ -36,6 +36,8 @@
 
 #define GFX_RAW 			0x12345678
 
+#define GFX_CACHE_EMPTY			0xffffffff	/* code has no slot in the decode cache */
+
 /*	When planeoffset[0] is set to GFX_RAW, the gfx data is left as-is, with no conversion.
    	No buffer is allocated for the decoded data, and gfxdata is set to point to the source
    	data.
@@ -118,6 +120,21 @@ struct _gfx_layout
 };
 
 
+/*	Decoded elements larger than GFX_CACHE_THRESHOLD bytes do not get a buffer for every
+	code. Codes are decoded on first use into a fixed number of slots instead, and the
+	least recently used ones (clock approximation) are recycled when the slots run out.
+	Pen usage is kept for evicted codes, so the transparency shortcuts keep working.
+	Pointers returned by gfx_element_get_data stay valid until the slots wrap around. */
+struct gfx_cache
+{
+	UINT32			*slot;				/* slot holding each code, or GFX_CACHE_EMPTY */
+	UINT32			*code;				/* code held by each slot, or GFX_CACHE_EMPTY */
+	UINT8			*referenced;			/* per-slot reference bits for the clock hand */
+	UINT32			slots;				/* number of slots */
+	UINT32			hand;				/* next slot considered for replacement */
+};
+
+
 class gfx_element
 {
 public:
@@ -144,6 +161,7 @@ public:
 	const UINT8		*srcdata;			/* pointer to the source data for decoding */
 	UINT8			*dirty;				/* dirty array for detecting tiles that need decoding */
 	UINT32			dirtyseq;			/* sequence number; incremented each time a tile is dirtied */
+	gfx_cache		*cache;				/* bounded decode cache, or NULL if every code has its own buffer */
 
 	running_machine *machine;				/* pointer to the owning machine */
 	gfx_layout		layout;				/* copy of the original layout */
@@ -349,6 +367,20 @@ INLINE void gfx_element_set_source(gfx_element *gfx, const UINT8 *source)
 INLINE const UINT8 *gfx_element_get_data(const gfx_element *gfx, UINT32 code)
 {
 	assert(code < gfx->total_elements);
+
+	/* cached elements keep decoded codes in slots rather than at their natural position */
+	if (gfx->cache != NULL)
+	{
+		UINT32 slot = gfx->cache->slot[code];
+		if (slot == GFX_CACHE_EMPTY || gfx->dirty[code])
+		{
+			gfx_element_decode(gfx, code);
+			slot = gfx->cache->slot[code];
+		}
+		gfx->cache->referenced[slot] = 1;
+		return gfx->gfxdata + slot * gfx->char_modulo + gfx->starty * gfx->line_modulo + gfx->startx;
+	}
+
 	if (gfx->dirty[code])
 		gfx_element_decode(gfx, code);
 	return gfx->gfxdata + code * gfx->char_modulo + gfx->starty * gfx->line_modulo + gfx->startx;
@@ -27,6 +27,8 @@
 ***************************************************************************/
 
 static int driver_lru[DRIVER_LRU_SIZE];
+static int *driver_sorted;			/* drivers[] indices sorted by name */
+static int driver_sorted_count;
 
 
 
@@ -35,6 +37,7 @@ static int driver_lru[DRIVER_LRU_SIZE];
 ***************************************************************************/
 
 static int penalty_compare(const char *source, const char *target);
+static int CLIB_DECL driver_sort_compare(const void *item1, const void *item2);
 
 
 
@@ -65,19 +68,59 @@ const game_driver *driver_get_name(const char *name)
 			return drivers[driver_lru[0]];
 		}
 
-	/* scan for a match in the drivers -- slow! */
-	for (drvnum = 0; drivers[drvnum] != NULL; drvnum++)
-		if (mame_stricmp(drivers[drvnum]->name, name) == 0)
-		{
-			memmove((void *)&driver_lru[1], (void *)&driver_lru[0], sizeof(driver_lru[0]) * (DRIVER_LRU_SIZE - 1));
-			driver_lru[0] = drvnum;
-			return drivers[drvnum];
-		}
+	/* look it up in the sorted index */
+	drvnum = driver_get_index(name);
+	if (drvnum >= 0)
+	{
+		memmove((void *)&driver_lru[1], (void *)&driver_lru[0], sizeof(driver_lru[0]) * (DRIVER_LRU_SIZE - 1));
+		driver_lru[0] = drvnum;
+		return drivers[drvnum];
+	}
 
 	return NULL;
 }
 
 
+/*-------------------------------------------------
+    driver_get_index - return the index in
+    drivers[] of a driver given its name, or -1
+-------------------------------------------------*/
+
+int driver_get_index(const char *name)
+{
+	int lo, hi;
+
+	/* sort the list once; it lives as long as the process */
+	if (driver_sorted == NULL)
+	{
+		int drvnum;
+
+		driver_sorted_count = driver_list_get_count(drivers);
+		driver_sorted = global_alloc_array(int, driver_sorted_count);
+		for (drvnum = 0; drvnum < driver_sorted_count; drvnum++)
+			driver_sorted[drvnum] = drvnum;
+		qsort(driver_sorted, driver_sorted_count, sizeof(driver_sorted[0]), driver_sort_compare);
+	}
+
+	/* binary search on the name */
+	lo = 0;
+	hi = driver_sorted_count - 1;
+	while (lo <= hi)
+	{
+		int mid = (lo + hi) / 2;
+		int cmp = mame_stricmp(name, drivers[driver_sorted[mid]]->name);
+
+		if (cmp == 0)
+			return driver_sorted[mid];
+		if (cmp < 0)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+	return -1;
+}
+
+
 /*-------------------------------------------------
     driver_get_clone - return a pointer to the
     clone of a game driver.
@@ -232,6 +275,17 @@ static int penalty_compare(const char *source, const char *target)
 }
 
 
+/*-------------------------------------------------
+    driver_sort_compare - compare two drivers[]
+    indices by driver name
+-------------------------------------------------*/
+
+static int CLIB_DECL driver_sort_compare(const void *item1, const void *item2)
+{
+	return mame_stricmp(drivers[*(const int *)item1]->name, drivers[*(const int *)item2]->name);
+}
+
+
 /*-------------------------------------------------
     driver_list_get_count - returns the amount of
     drivers
@@ -129,6 +129,7 @@ GAME_EXTERN(empty);
 ***************************************************************************/
 
 const game_driver *driver_get_name(const char *name);
+int driver_get_index(const char *name);
 const game_driver *driver_get_clone(const game_driver *driver);
 const game_driver *driver_get_compatible(const game_driver *drv);
 
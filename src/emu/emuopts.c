@@ -68,6 +68,7 @@ const options_entry mame_core_options[] =
 	{ "mngwrite",                    NULL,        0,                 "optional filename to write a MNG movie of the current session" },
 	{ "aviwrite",                    NULL,        0,                 "optional filename to write an AVI movie of the current session" },
 	{ "wavwrite",                    NULL,        0,                 "optional filename to write a WAV file of the current session" },
+	{ "soundlog",                    NULL,        0,                 "optional filename to write a log of the sound chip register writes of the current session" },
 	{ "snapname",                    "%g/%i",     0,                 "override of the default snapshot/movie naming; %g == gamename, %i == index" },
 	{ "snapsize",                    "auto",      0,                 "specify snapshot/movie resolution (<width>x<height>) or 'auto' to use minimal size " },
 	{ "snapview",                    "internal",  0,                 "specify snapshot/movie view or 'internal' to use internal pixel-aspect views" },
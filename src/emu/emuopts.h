@@ -72,6 +72,7 @@
 #define OPTION_MNGWRITE				"mngwrite"
 #define OPTION_AVIWRITE				"aviwrite"
 #define OPTION_WAVWRITE				"wavwrite"
+#define OPTION_SOUNDLOG				"soundlog"
 #define OPTION_SNAPNAME				"snapname"
 #define OPTION_SNAPSIZE				"snapsize"
 #define OPTION_SNAPVIEW				"snapview"
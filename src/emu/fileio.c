@@ -56,8 +56,11 @@ struct _mame_file
 	UINT32			openflags;						/* flags we used for the open */
 	char			hash[HASH_BUF_SIZE];			/* hash data for the file */
 	zip_file *		zipfile;						/* ZIP file pointer */
+	UINT8			zipped;							/* did the file come out of a ZIP? */
 	UINT8 *			zipdata;						/* ZIP file data */
+	UINT8			zipmapped;						/* is the data mapped from the archive? */
 	UINT64			ziplength;						/* ZIP file length */
+	UINT32			zipcrc;							/* CRC of the data actually inflated */
 };
 
 
@@ -89,8 +92,7 @@ static int path_iterator_get_next(path_iterator *iterator, astring &buffer);
 
 /* misc helpers */
 static file_error load_zipped_file(mame_file *file);
-static int zip_filename_match(const zip_file_header *header, const astring &afilename);
-static int zip_header_is_path(const zip_file_header *header);
+static void free_zipped_data(mame_file *file);
 
 
 
@@ -309,22 +311,16 @@ static file_error fopen_attempt_zipped(astring &fullname, UINT32 crc, UINT32 ope
 			continue;
 
 		/* see if we can find a file with the right name and (if available) crc */
-		for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-			if (zip_filename_match(header, filename) && (!(openflags & OPEN_FLAG_HAS_CRC) || header->crc == crc))
-				break;
+		header = zip_file_find_name(zip, filename, (openflags & OPEN_FLAG_HAS_CRC) != 0, crc);
 
 		/* if that failed, look for a file with the right crc, but the wrong filename */
 		if (header == NULL && (openflags & OPEN_FLAG_HAS_CRC))
-			for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-				if (header->crc == crc && (!zip_header_is_path(header)))
-					break;
+			header = zip_file_find_crc(zip, crc);
 
 		/* if that failed, look for a file with the right name; reporting a bad checksum */
 		/* is more helpful and less confusing than reporting "rom not found" */
-		if (header == NULL)
-			for (header = zip_file_first_file(zip); header != NULL; header = zip_file_next_file(zip))
-				if (zip_filename_match(header, filename))
-					break;
+		if (header == NULL && (openflags & OPEN_FLAG_HAS_CRC))
+			header = zip_file_find_name(zip, filename, FALSE, 0);
 
 		/* if we got it, read the data */
 		if (header != NULL)
@@ -332,6 +328,7 @@ static file_error fopen_attempt_zipped(astring &fullname, UINT32 crc, UINT32 ope
 			UINT8 crcs[4];
 
 			file->zipfile = zip;
+			file->zipped = TRUE;
 			file->ziplength = header->uncompressed_length;
 
 			/* build a hash with just the CRC */
@@ -370,8 +367,7 @@ void mame_fclose(mame_file *file)
 		zip_file_close(file->zipfile);
 	if (file->file != NULL)
 		core_fclose(file->file);
-	if (file->zipdata != NULL)
-		global_free(file->zipdata);
+	free_zipped_data(file);
 	global_free(file);
 }
 
@@ -391,6 +387,45 @@ file_error mame_fclose_and_open_next(mame_file **file, const char *filename, UIN
 }
 
 
+/*-------------------------------------------------
+    mame_fpreload - inflate a file opened with
+    OPEN_FLAG_NO_PRELOAD ahead of its first use;
+    safe to call from a work item as long as
+    nothing else touches the file meanwhile
+-------------------------------------------------*/
+
+file_error mame_fpreload(mame_file *file)
+{
+	zip_error ziperr;
+
+	/* loose files and files already inflated have nothing to do */
+	if (file->zipfile == NULL || file->zipdata != NULL)
+		return FILERR_NONE;
+
+	/* stored data is used in place, straight from the archive */
+	file->zipdata = (UINT8 *)zip_file_map(file->zipfile);
+	if (file->zipdata != NULL)
+	{
+		file->zipmapped = TRUE;
+		file->zipcrc = file->zipfile->data_crc;
+		return FILERR_NONE;
+	}
+
+	/* allocate some memory */
+	file->zipdata = global_alloc_array(UINT8, file->ziplength);
+
+	/* read the data into our buffer and return */
+	ziperr = zip_file_decompress(file->zipfile, file->zipdata, file->ziplength);
+	if (ziperr != ZIPERR_NONE)
+	{
+		free_zipped_data(file);
+		return FILERR_FAILURE;
+	}
+	file->zipcrc = file->zipfile->data_crc;
+	return FILERR_NONE;
+}
+
+
 /*-------------------------------------------------
     mame_fcompress - enable/disable streaming file
     compression via zlib; level is 0 to disable
@@ -748,6 +783,35 @@ const astring &mame_file_full_name(mame_file *file)
 }
 
 
+/*-------------------------------------------------
+    mame_file_is_zipped - return TRUE if the file
+    is an entry in a ZIP archive
+-------------------------------------------------*/
+
+int mame_file_is_zipped(mame_file *file)
+{
+	return file->zipped;
+}
+
+
+/*-------------------------------------------------
+    mame_fmap - take over a mapping of the full
+    file data, for loose files and stored ZIP
+    entries; NULL if the data is not mapped
+-------------------------------------------------*/
+
+void *mame_fmap(mame_file *file)
+{
+	/* load the ZIP file now if we haven't yet */
+	if (file->zipfile != NULL && load_zipped_file(file) != FILERR_NONE)
+		return NULL;
+	if (file->file == NULL)
+		return NULL;
+
+	return core_fmap(file->file);
+}
+
+
 /*-------------------------------------------------
     mame_fhash - returns the hash for a file
 -------------------------------------------------*/
@@ -839,32 +903,42 @@ static int path_iterator_get_next(path_iterator *iterator, astring &buffer)
 static file_error load_zipped_file(mame_file *file)
 {
 	file_error filerr;
-	zip_error ziperr;
 
 	assert(file->file == NULL);
-	assert(file->zipdata == NULL);
 	assert(file->zipfile != NULL);
 
-	/* allocate some memory */
-	file->zipdata = global_alloc_array(UINT8, file->ziplength);
+	/* inflate now, unless mame_fpreload already did */
+	if (file->zipdata == NULL && mame_fpreload(file) != FILERR_NONE)
+		return FILERR_FAILURE;
 
-	/* read the data into our buffer and return */
-	ziperr = zip_file_decompress(file->zipfile, file->zipdata, file->ziplength);
-	if (ziperr != ZIPERR_NONE)
+	/* the hash now describes what we actually inflated */
+	if (file->zipcrc != file->zipfile->header.crc)
 	{
-		global_free(file->zipdata);
-		file->zipdata = NULL;
-		return FILERR_FAILURE;
+		UINT8 crcs[4];
+
+		crcs[0] = file->zipcrc >> 24;
+		crcs[1] = file->zipcrc >> 16;
+		crcs[2] = file->zipcrc >> 8;
+		crcs[3] = file->zipcrc >> 0;
+		hash_data_clear(file->hash);
+		hash_data_insert_binary_checksum(file->hash, HASH_CRC, crcs);
 	}
 
-	/* convert to RAM file */
-	filerr = core_fopen_ram(file->zipdata, file->ziplength, file->openflags, &file->file);
+	/* convert to RAM file; a mapping is handed over to it */
+	if (file->zipmapped)
+		filerr = core_fopen_mapped(file->zipdata, file->ziplength, file->openflags, &file->file);
+	else
+		filerr = core_fopen_ram(file->zipdata, file->ziplength, file->openflags, &file->file);
 	if (filerr != FILERR_NONE)
 	{
-		global_free(file->zipdata);
-		file->zipdata = NULL;
+		free_zipped_data(file);
 		return FILERR_FAILURE;
 	}
+	if (file->zipmapped)
+	{
+		file->zipdata = NULL;
+		file->zipmapped = FALSE;
+	}
 
 	/* close out the ZIP file */
 	zip_file_close(file->zipfile);
@@ -874,26 +948,16 @@ static file_error load_zipped_file(mame_file *file)
 
 
 /*-------------------------------------------------
-    zip_filename_match - compare zip filename
-    to expected filename, ignoring any directory
+    free_zipped_data - release the data of a
+    ZIPped file, however it was obtained
 -------------------------------------------------*/
 
-static int zip_filename_match(const zip_file_header *header, const astring &filename)
+static void free_zipped_data(mame_file *file)
 {
-	const char *zipfile = header->filename + header->filename_length - filename.len();
-
-	return (zipfile >= header->filename && filename.icmp(zipfile) == 0 &&
-		(zipfile == header->filename || zipfile[-1] == '/'));
-}
-
-/*-------------------------------------------------
-    zip_header_is_path - check whether filename
-                         in header is a path
-  -------------------------------------------------*/
-
-static int zip_header_is_path(const zip_file_header *header)
-{
-	const char *zipfile = header->filename + header->filename_length - 1;
-
-	return (zipfile >= header->filename && zipfile[0] == '/');
+	if (file->zipdata != NULL && file->zipmapped)
+		osd_unmap(file->zipdata, file->ziplength);
+	else if (file->zipdata != NULL)
+		global_free(file->zipdata);
+	file->zipdata = NULL;
+	file->zipmapped = FALSE;
 }
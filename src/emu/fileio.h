@@ -101,6 +101,9 @@ void mame_fclose(mame_file *file);
 /* close an open file, and open the next entry in the original searchpath*/
 file_error mame_fclose_and_open_next(mame_file **file, const char *filename, UINT32 openflags);
 
+/* inflate a file opened with OPEN_FLAG_NO_PRELOAD ahead of its first use; may run on a work queue */
+file_error mame_fpreload(mame_file *file);
+
 /* enable/disable streaming file compression via zlib; level is 0 to disable compression, or up to 9 for max compression */
 file_error mame_fcompress(mame_file *file, int compress);
 
@@ -172,6 +175,13 @@ core_file *mame_core_file(mame_file *file);
 /* return the full filename for a given mame_file */
 const astring &mame_file_full_name(mame_file *file);
 
+/* return TRUE if the file is an entry in a ZIP archive */
+int mame_file_is_zipped(mame_file *file);
+
+/* take over a mapping of the full file data (loose files and stored ZIP entries only); */
+/* returns NULL otherwise; release it with osd_unmap after closing the file */
+void *mame_fmap(mame_file *file);
+
 /* return a hash string for the file with the given functions */
 const char *mame_fhash(mame_file *file, UINT32 functions);
 
@@ -264,6 +264,8 @@ const char *running_machine::describe_context()
 
 void running_machine::start()
 {
+	startup_trace_scope trace("machine", "start");
+
 	// initialize basic can't-fail systems here
 	fileio_init(this);
 	config_init(this);
@@ -305,15 +307,24 @@ void running_machine::start()
 
 	// first load ROMs, then populate memory, and finally initialize CPUs
 	// these operations must proceed in this order
-	rom_init(this);
-	memory_init(this);
+	{
+		startup_trace_scope trace("machine", "rom_init");
+		rom_init(this);
+	}
+	{
+		startup_trace_scope trace("machine", "memory_init");
+		memory_init(this);
+	}
 	watchdog_init(this);
 
 	// must happen after memory_init because this relies on generic.spriteram
 	generic_video_init(this);
 
 	// allocate the gfx elements prior to device initialization
-	gfx_init(this);
+	{
+		startup_trace_scope trace("machine", "gfx_init");
+		gfx_init(this);
+	}
 
 	// initialize natural keyboard support
 	inputx_init(this);
@@ -322,33 +333,53 @@ void running_machine::start()
 	image_init(this);
 
 	// start up the devices
-	m_devicelist.start_all();
+	{
+		startup_trace_scope trace("machine", "start_all");
+		m_devicelist.start_all();
+	}
 
 	// call the game driver's init function
 	// this is where decryption is done and memory maps are altered
 	// so this location in the init order is important
 	ui_set_startup_text(this, "Initializing...", true);
 	if (m_game.driver_init != NULL)
+	{
+		startup_trace_scope trace("driver", "DRIVER_INIT");
 		(*m_game.driver_init)(this);
+	}
 
 	// finish image devices init process
 	image_postdevice_init(this);
 
 	// start the video and audio hardware
-	video_init(this);
-	tilemap_init(this);
-	crosshair_init(this);
-
-	sound_init(this);
+	{
+		startup_trace_scope trace("machine", "video_init");
+		video_init(this);
+		tilemap_init(this);
+		crosshair_init(this);
+	}
+	{
+		startup_trace_scope trace("machine", "sound_init");
+		sound_init(this);
+	}
 
 	// initialize the debugger
 	if ((debug_flags & DEBUG_FLAG_ENABLED) != 0)
 		debugger_init(this);
 
 	// call the driver's _START callbacks
-	m_driver_data->machine_start();
-	m_driver_data->sound_start();
-	m_driver_data->video_start();
+	{
+		startup_trace_scope trace("driver", "MACHINE_START");
+		m_driver_data->machine_start();
+	}
+	{
+		startup_trace_scope trace("driver", "SOUND_START");
+		m_driver_data->sound_start();
+	}
+	{
+		startup_trace_scope trace("driver", "VIDEO_START");
+		m_driver_data->video_start();
+	}
 
 	// if we're coming in with a savegame request, process it now
 	const char *savegame = options_get_string(&m_options, OPTION_STATE);
@@ -392,15 +423,24 @@ int running_machine::run(bool firstrun)
 	start();
 
 	// load the configuration settings and NVRAM
-	config_load_settings(this);
-	nvram_load(this);
+	{
+		startup_trace_scope trace("machine", "config and nvram");
+		config_load_settings(this);
+		nvram_load(this);
+	}
 	sound_mute(this, FALSE);
 
 	// display the startup screens
-	ui_display_startup_screens(this, firstrun, !options_get_bool(&m_options, OPTION_SKIP_NAGSCREEN));	/* Invalid */
+	{
+		startup_trace_scope trace("machine", "startup screens");
+		ui_display_startup_screens(this, firstrun, !options_get_bool(&m_options, OPTION_SKIP_NAGSCREEN));	/* Invalid */
+	}
 
 	// perform a soft reset -- this takes us to the running phase
-	soft_reset();
+	{
+		startup_trace_scope trace("machine", "soft_reset");
+		soft_reset();
+	}
 
 	// run the CPUs until a reset or exit
 	m_hard_reset_pending = false;
@@ -964,7 +1004,8 @@ region_info::region_info(running_machine &machine, const char *name, UINT32 leng
 	m_next(NULL),
 	m_name(name),
 	m_length(length),
-	m_flags(flags)
+	m_flags(flags),
+	m_mapped(false)
 {
 	m_base.u8 = auto_alloc_array(&machine, UINT8, length);
 }
@@ -976,7 +1017,24 @@ region_info::region_info(running_machine &machine, const char *name, UINT32 leng
 
 region_info::~region_info()
 {
+	if (m_mapped)
+		osd_unmap(m_base.v, m_length);
+	else
+		auto_free(&m_machine, m_base.v);
+}
+
+
+//-------------------------------------------------
+//	map - replace the allocated memory with a
+//	mapping of the ROM file that fills the region
+//-------------------------------------------------
+
+void region_info::map(void *base)
+{
+	assert(!m_mapped);
 	auto_free(&m_machine, m_base.v);
+	m_base.v = base;
+	m_mapped = true;
 }
 
 
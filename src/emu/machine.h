@@ -227,6 +227,9 @@ public:
 	operator INT64 *() const { return (this != NULL) ? m_base.i64 : NULL; }
 	operator UINT64 *() const { return (this != NULL) ? m_base.u64 : NULL; }
 
+	// back the region with an osd_map mapping of its full length instead
+	void map(void *base);
+
 private:
 	// internal data
 	running_machine		&m_machine;
@@ -235,6 +238,7 @@ private:
 	generic_ptr			m_base;
 	UINT32				m_length;
 	UINT32				m_flags;
+	bool				m_mapped;
 };
 
 
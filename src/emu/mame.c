@@ -180,20 +180,28 @@ int mame_execute(core_options *options)
 				started_empty = true;
 		}
 		// otherwise, perform validity checks before anything else
-		else if (mame_validitychecks(driver) != 0)
-			return MAMERR_FAILED_VALIDITY;
+		else
+		{
+			startup_trace_scope trace("driver", "mame_validitychecks");
+			if (mame_validitychecks(driver) != 0)
+				return MAMERR_FAILED_VALIDITY;
+		}
 
 		firstgame = false;
 
 		// parse any INI files as the first thing
 		if (options_get_bool(options, OPTION_READCONFIG))
 		{
+			startup_trace_scope trace("options", "ini files");
 			options_revert(options, OPTION_PRIORITY_INI);
 			mame_parse_ini_files(options, driver);
 		}
 
-		retro_global_config = global_alloc(machine_config(driver->machine_config));
-		retro_global_machine = global_alloc(running_machine(*driver, *retro_global_config, *options, started_empty));
+		{
+			startup_trace_scope trace("driver", "machine_config");
+			retro_global_config = global_alloc(machine_config(driver->machine_config));
+			retro_global_machine = global_alloc(running_machine(*driver, *retro_global_config, *options, started_empty));
+		}
 		global_machine = retro_global_machine;
 
 		error = retro_global_machine->run(firstrun);
@@ -43,6 +43,15 @@
 
 
 
+//**************************************************************************
+//  CONSTANTS
+//**************************************************************************
+
+const int STARTUP_TRACE_MAX_EVENTS = 8192;
+const int STARTUP_TRACE_MAX_THREADS = 64;
+
+
+
 //**************************************************************************
 //  TYPE DEFINITIONS
 //**************************************************************************
@@ -54,6 +63,17 @@ struct profile_string
 };
 
 
+// one finished span of the startup trace
+struct startup_trace_event
+{
+	const char *		category;					// category of the span
+	char				name[64];					// copy of the name of the span
+	int					thread;						// track, 0 for the main thread
+	osd_ticks_t			start;						// start time
+	osd_ticks_t			end;						// end time
+};
+
+
 
 //**************************************************************************
 //  GLOBAL VARIABLES
@@ -61,6 +81,14 @@ struct profile_string
 
 profiler_state g_profiler;
 
+bool g_startup_trace;
+
+static osd_lock *startup_trace_lock;
+static startup_trace_event *startup_trace_events;
+static int startup_trace_count;
+static int startup_trace_dropped;
+static osd_ticks_t startup_trace_origin;
+
 
 
 //**************************************************************************
@@ -274,3 +302,115 @@ const char *real_profiler_state::text(running_machine &machine, astring &string)
 	g_profiler.stop();
 	return string;
 }
+
+
+
+//**************************************************************************
+//  STARTUP TRACE
+//**************************************************************************
+
+//-------------------------------------------------
+//  startup_trace_start - begin recording the
+//  startup trace
+//-------------------------------------------------
+
+void startup_trace_start(osd_ticks_t origin)
+{
+	// the trace spans several machines, so it lives outside the tracked pools
+	if (startup_trace_lock == NULL)
+		startup_trace_lock = osd_lock_alloc();
+	if (startup_trace_events == NULL)
+		startup_trace_events = (startup_trace_event *)osd_malloc(STARTUP_TRACE_MAX_EVENTS * sizeof(startup_trace_event));
+	if (startup_trace_lock == NULL || startup_trace_events == NULL)
+		return;
+
+	startup_trace_count = 0;
+	startup_trace_dropped = 0;
+	startup_trace_origin = origin;
+	g_startup_trace = true;
+}
+
+
+//-------------------------------------------------
+//  startup_trace_add - record a finished span
+//-------------------------------------------------
+
+void startup_trace_add(const char *category, const char *name, int thread, osd_ticks_t start, osd_ticks_t end)
+{
+	if (!g_startup_trace)
+		return;
+
+	osd_lock_acquire(startup_trace_lock);
+	if (g_startup_trace && startup_trace_count < STARTUP_TRACE_MAX_EVENTS)
+	{
+		startup_trace_event &event = startup_trace_events[startup_trace_count++];
+
+		event.category = category;
+		strncpy(event.name, name, sizeof(event.name) - 1);
+		event.name[sizeof(event.name) - 1] = 0;
+		event.thread = MIN(thread, STARTUP_TRACE_MAX_THREADS - 1);
+		event.start = start;
+		event.end = end;
+	}
+	else
+		startup_trace_dropped++;
+	osd_lock_release(startup_trace_lock);
+}
+
+
+//-------------------------------------------------
+//  startup_trace_stop - stop recording and write
+//  the spans as a Chrome trace
+//-------------------------------------------------
+
+int startup_trace_stop(const char *filename)
+{
+	bool threadused[STARTUP_TRACE_MAX_THREADS] = { false };
+	double microseconds_per_tick = 1000000.0 / (double)osd_ticks_per_second();
+	core_file *file;
+
+	if (!g_startup_trace)
+		return FALSE;
+
+	// late spans from the work queue are dropped from here on
+	osd_lock_acquire(startup_trace_lock);
+	g_startup_trace = false;
+	osd_lock_release(startup_trace_lock);
+
+	if (core_fopen(filename, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_NO_BOM, &file) != FILERR_NONE)
+		return FALSE;
+
+	core_fprintf(file, "{\"traceEvents\":[\n");
+	for (int eventnum = 0; eventnum < startup_trace_count; eventnum++)
+	{
+		const startup_trace_event &event = startup_trace_events[eventnum];
+		char name[sizeof(event.name)];
+		int length = 0;
+
+		// names are ROM file names and tags; keep them valid JSON strings
+		for (const char *src = event.name; *src != 0; src++)
+			if (*src != '"' && *src != '\\' && (UINT8)*src >= 0x20)
+				name[length++] = *src;
+		name[length] = 0;
+
+		threadused[event.thread] = true;
+		core_fprintf(file, "{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f},\n",
+				event.category, name, event.thread,
+				(double)(event.start - startup_trace_origin) * microseconds_per_tick,
+				(double)(event.end - event.start) * microseconds_per_tick);
+	}
+
+	// name the tracks
+	for (int thread = 0; thread < STARTUP_TRACE_MAX_THREADS; thread++)
+		if (threadused[thread])
+		{
+			if (thread == 0)
+				core_fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}},\n");
+			else
+				core_fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"worker %d\"}},\n", thread, thread - 1);
+		}
+	core_fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"startup\"}}\n");
+	core_fprintf(file, "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%d}}\n", startup_trace_dropped);
+	core_fclose(file);
+	return TRUE;
+}
@@ -36,6 +36,12 @@
 	    your_work_here();
 	}
     the profiler handles a FILO list so calls may be nested.
+
+	The startup trace works the same way with startup_trace_scope, but
+	records every span with its start time instead of accumulating
+	buckets, and is written out as a Chrome trace (chrome://tracing or
+	Perfetto) once the first frame has run. Spans from work queue
+	callbacks pass threadid + 1 so each worker gets its own track.
 ***************************************************************************/
 
 #pragma once
@@ -90,6 +96,24 @@ DECLARE_ENUM_OPERATORS(profile_type);
 
 
 
+//*************************************************************************/
+//  STARTUP TRACE
+//*************************************************************************/
+
+// TRUE while the startup trace is recording
+extern bool g_startup_trace;
+
+// begin recording, with time 0 at origin
+void startup_trace_start(osd_ticks_t origin);
+
+// add a finished span; safe to call from any thread
+void startup_trace_add(const char *category, const char *name, int thread, osd_ticks_t start, osd_ticks_t end);
+
+// stop recording and write the trace; returns FALSE if it could not be written
+int startup_trace_stop(const char *filename);
+
+
+
 //*************************************************************************/
 //  TYPE DEFINITIONS
 //*************************************************************************/
@@ -176,6 +200,28 @@ public:
 };
 
 
+// ======================> startup_trace_scope
+
+class startup_trace_scope
+{
+public:
+	// construction/destruction
+	startup_trace_scope(const char *category, const char *name, int thread = 0)
+		: m_category(category),
+		  m_name(name),
+		  m_thread(thread),
+		  m_start(g_startup_trace ? osd_ticks() : 0) { }
+	~startup_trace_scope() { if (m_start != 0) startup_trace_add(m_category, m_name, m_thread, m_start, osd_ticks()); }
+
+private:
+	// internal state
+	const char *		m_category;					// category of the span
+	const char *		m_name;						// name of the span
+	int					m_thread;					// track, 0 for the main thread
+	osd_ticks_t			m_start;					// start time, 0 if not tracing
+};
+
+
 // ======================> profiler_state
 
 #ifdef MAME_PROFILER
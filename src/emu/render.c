@@ -57,6 +57,9 @@
 
 #define NUM_PRIMLISTS			3
 
+#define MAX_RETAINED_TEXTURES		8
+#define RETAINED_SIGNATURE_BYTES	1024
+
 #define MAX_CLEAR_EXTENTS		1000
 
 #define INTERNAL_FLAG_CHAR		0x00000001
@@ -96,6 +99,7 @@ enum
 typedef struct _object_transform object_transform;
 typedef struct _scaled_texture scaled_texture;
 typedef struct _container_item container_item;
+typedef struct _retained_texture retained_texture;
 
 
 /* a render_ref is an abstract reference to an internal object of some sort */
@@ -143,6 +147,17 @@ struct render_texture
 };
 
 
+/* a retained_texture links a textured primitive of a retained list back to its source */
+struct _retained_texture
+{
+	render_primitive	*prim;					/* primitive to refresh */
+	render_container	*container;				/* container holding the source item */
+	int				itemindex;			/* index of the item in the container, or -1 for the overlay */
+	UINT32				dwidth;				/* requested scaled width */
+	UINT32				dheight;			/* requested scaled height */
+};
+
+
 /* a render_target describes a surface that is being rendered to */
 class render_target
 {
@@ -167,6 +182,11 @@ public:
 	int				maxtexwidth;			/* maximum width of a texture */
 	int				maxtexheight;			/* maximum height of a texture */
 	render_container	*debug_containers;
+	int				retained_list;			/* index of the primlist that can be reused, or -1 */
+	int				retained_count;			/* number of retained textures, or -1 if not retainable */
+	retained_texture		retained[MAX_RETAINED_TEXTURES];	/* textured primitives of the retained list */
+	int				retained_siglen;		/* length of the retained structural signature */
+	UINT8				retained_sig[RETAINED_SIGNATURE_BYTES];	/* structural signature of the retained list */
 };
 
 
@@ -276,6 +296,9 @@ static int load_layout_files(render_target *target, const char *layoutfile, int
 static void add_container_primitives(render_target *target, render_primitive_list *list, const object_transform *xform, render_container *container, int blendmode);
 static void add_element_primitives(render_target *target, render_primitive_list *list, const object_transform *xform, const layout_element *element, int state, int blendmode);
 static void add_clear_and_optimize_primitive_list(render_target *target, render_primitive_list *list);
+static void add_retained_texture(render_target *target, render_primitive *prim, render_container *container, int itemindex, UINT32 dwidth, UINT32 dheight);
+static int compute_retained_signature(render_target *target, UINT8 *sig);
+static void refresh_retained_list(render_target *target, render_primitive_list *list);
 
 /* render references */
 static void invalidate_all_render_ref(void *refptr);
@@ -1105,6 +1128,7 @@ render_target *render_target_alloc(running_machine *machine, const char *layoutf
 	target->layerconfig = LAYER_CONFIG_DEFAULT;
 	target->maxtexwidth = 65536;
 	target->maxtexheight = 65536;
+	target->retained_list = -1;
 
 	/* determine the base layer configuration based on options */
 	target->base_layerconfig = LAYER_CONFIG_DEFAULT;
@@ -1556,11 +1580,24 @@ const render_primitive_list *render_target_get_primitives(render_target *target)
 	object_transform root_xform, ui_xform;
 	int itemcount[ITEM_LAYER_MAX];
 	INT32 viswidth, visheight;
+	UINT8 signature[RETAINED_SIGNATURE_BYTES];
+	int siglen;
 
 	/* remember the base values if this is the first frame */
 	if (target->base_view == NULL)
 		target->base_view = target->curview;
 
+	/* if nothing structural changed, reuse the last list and just refresh its textures */
+	siglen = compute_retained_signature(target, signature);
+	if (siglen >= 0 && target->retained_list >= 0 && siglen == target->retained_siglen && memcmp(signature, target->retained_sig, siglen) == 0)
+	{
+		render_primitive_list *list = &target->primlist[target->retained_list];
+		refresh_retained_list(target, list);
+		return list;
+	}
+	target->retained_list = -1;
+	target->retained_count = 0;
+
 	/* switch to the next primitive list */
 	int listnum = target->listindex;
 	target->listindex = (target->listindex + 1) % ARRAY_LENGTH(target->primlist);
@@ -1621,6 +1658,9 @@ const render_primitive_list *render_target_get_primitives(render_target *target)
 					if (item->element != NULL)
 					{
 						int state = 0;
+
+						/* element states can change at any time */
+						target->retained_count = -1;
 						if (item->output_name[0] != 0)
 							state = output_get_value(item->output_name);
 						else if (item->input_tag[0] != 0)
@@ -1703,6 +1743,14 @@ const render_primitive_list *render_target_get_primitives(render_target *target)
 	add_clear_and_optimize_primitive_list(target, &target->primlist[listnum]);
 	osd_lock_release(target->primlist[listnum].lock);
 
+	/* remember the list for reuse if it can be refreshed in place */
+	if (siglen >= 0 && target->retained_count >= 0)
+	{
+		target->retained_list = listnum;
+		target->retained_siglen = siglen;
+		memcpy(target->retained_sig, signature, siglen);
+	}
+
 	return &target->primlist[listnum];
 }
 
@@ -1933,6 +1981,7 @@ static void add_container_primitives(render_target *target, render_primitive_lis
 	render_bounds cliprect;
 	render_primitive *prim;
 	container_item *item;
+	int itemindex;
 
 	/* first update the palette for the container, if it is dirty */
 	render_container_update_palette(container);
@@ -1974,10 +2023,10 @@ static void add_container_primitives(render_target *target, render_primitive_lis
 	}
 
 	/* iterate over elements */
-	for (item = container->itemlist; item != NULL; item = item->next)
+	for (item = container->itemlist, itemindex = 0; item != NULL; item = item->next, itemindex++)
 	{
 		render_bounds bounds;
-		int width, height;
+		int width = 0, height = 0;
 		int clipped = TRUE;
 
 		/* compute the oriented bounds */
@@ -2088,7 +2137,11 @@ static void add_container_primitives(render_target *target, render_primitive_lis
 
 		/* add to the list or free if we're clipped out */
 		if (!clipped)
+		{
 			append_render_primitive(list, prim);
+			if (item->type == CONTAINER_ITEM_QUAD && item->texture != NULL)
+				add_retained_texture(target, prim, container, itemindex, width, height);
+		}
 		else
 			free_render_primitive(prim);
 	}
@@ -2114,6 +2167,9 @@ static void add_container_primitives(render_target *target, render_primitive_lis
 			/* set the flags and add it to the list */
 			prim->flags = PRIMFLAG_TEXORIENT(container_xform.orientation) | PRIMFLAG_BLENDMODE(BLENDMODE_RGB_MULTIPLY) | PRIMFLAG_TEXFORMAT(container->overlaytexture->format);
 			append_render_primitive(list, prim);
+			add_retained_texture(target, prim, container, -1,
+					(container_xform.orientation & ORIENTATION_SWAP_XY) ? height : width,
+					(container_xform.orientation & ORIENTATION_SWAP_XY) ? width : height);
 		}
 		else
 			free_render_primitive(prim);
@@ -2450,6 +2506,171 @@ done:
 }
 
 
+/*-------------------------------------------------
+    add_retained_texture - remember where a
+    textured primitive came from, so that a
+    retained list can be refreshed in place
+-------------------------------------------------*/
+
+static void add_retained_texture(render_target *target, render_primitive *prim, render_container *container, int itemindex, UINT32 dwidth, UINT32 dheight)
+{
+	retained_texture *retained;
+
+	/* too many textures to track means the list can't be retained */
+	if (target->retained_count < 0)
+		return;
+	if (target->retained_count >= MAX_RETAINED_TEXTURES)
+	{
+		target->retained_count = -1;
+		return;
+	}
+
+	retained = &target->retained[target->retained_count++];
+	retained->prim = prim;
+	retained->container = container;
+	retained->itemindex = itemindex;
+	retained->dwidth = dwidth;
+	retained->dheight = dheight;
+}
+
+
+/*-------------------------------------------------
+    compute_retained_signature - capture the state
+    that determines the structure of a target's
+    primitive list; returns the length, or -1 if
+    the list must be rebuilt every frame
+-------------------------------------------------*/
+
+#define SIGNATURE_ADD(value) \
+	do { if (len + sizeof(value) > RETAINED_SIGNATURE_BYTES) return -1; memcpy(&sig[len], &(value), sizeof(value)); len += sizeof(value); } while (0)
+
+static int compute_retained_signature(render_target *target, UINT8 *sig)
+{
+	int len = 0;
+
+	/* only while running, and never with the UI or debugger on top */
+	if (target->machine->phase() < MACHINE_PHASE_RESET || target->debug_containers != NULL)
+		return -1;
+	if (target == render_get_ui_target() && !render_container_is_empty(ui_container))
+		return -1;
+
+	/* target geometry */
+	SIGNATURE_ADD(target->curview);
+	SIGNATURE_ADD(target->width);
+	SIGNATURE_ADD(target->height);
+	SIGNATURE_ADD(target->bounds);
+	SIGNATURE_ADD(target->pixel_aspect);
+	SIGNATURE_ADD(target->orientation);
+	SIGNATURE_ADD(target->layerconfig);
+	SIGNATURE_ADD(target->maxtexwidth);
+	SIGNATURE_ADD(target->maxtexheight);
+
+	/* walk the view the same way render_target_get_primitives does */
+	for (int layernum = 0; layernum < ITEM_LAYER_MAX; layernum++)
+	{
+		int blendmode;
+		int layer = get_layer_and_blendmode(target->curview, layernum, &blendmode);
+
+		if (!target->curview->layenabled[layer])
+			continue;
+
+		for (view_item *item = target->curview->itemlist[layer]; item != NULL; item = item->next)
+		{
+			/* artwork elements depend on outputs and inputs; don't bother */
+			if (item->element != NULL)
+				return -1;
+
+			render_container *container = get_screen_container_by_index(item->index);
+			SIGNATURE_ADD(container);
+			SIGNATURE_ADD(container->orientation);
+			SIGNATURE_ADD(container->brightness);
+			SIGNATURE_ADD(container->contrast);
+			SIGNATURE_ADD(container->gamma);
+			SIGNATURE_ADD(container->xscale);
+			SIGNATURE_ADD(container->yscale);
+			SIGNATURE_ADD(container->xoffset);
+			SIGNATURE_ADD(container->yoffset);
+			SIGNATURE_ADD(container->overlaytexture);
+
+			for (container_item *citem = container->itemlist; citem != NULL; citem = citem->next)
+			{
+				SIGNATURE_ADD(citem->type);
+				SIGNATURE_ADD(citem->bounds);
+				SIGNATURE_ADD(citem->color);
+				SIGNATURE_ADD(citem->flags);
+				SIGNATURE_ADD(citem->internal);
+				SIGNATURE_ADD(citem->width);
+
+				/* textures may alternate between frames, but must look the same */
+				if (citem->texture != NULL)
+				{
+					if (citem->texture->bitmap == NULL)
+						return -1;
+					SIGNATURE_ADD(citem->texture->format);
+					SIGNATURE_ADD(citem->texture->sbounds);
+					SIGNATURE_ADD(citem->texture->palette);
+					SIGNATURE_ADD(citem->texture->scaler);
+				}
+			}
+		}
+	}
+
+	return len;
+}
+
+#undef SIGNATURE_ADD
+
+
+/*-------------------------------------------------
+    refresh_retained_list - point the textured
+    primitives of a retained list at the current
+    bitmaps, palettes and sequence IDs
+-------------------------------------------------*/
+
+static void refresh_retained_list(render_target *target, render_primitive_list *list)
+{
+	osd_lock_acquire(list->lock);
+
+	/* drop the old references; refreshing adds the current ones */
+	while (list->reflist != NULL)
+	{
+		render_ref *temp = list->reflist;
+		list->reflist = temp->next;
+		free_render_ref(temp);
+	}
+
+	for (int index = 0; index < target->retained_count; index++)
+	{
+		retained_texture *retained = &target->retained[index];
+		render_container *container = retained->container;
+		render_texture *texture;
+
+		/* a primitive optimized into a plain rectangle has nothing to refresh */
+		if (retained->prim->texture.base == NULL)
+			continue;
+
+		/* find the current source texture */
+		if (retained->itemindex < 0)
+			texture = container->overlaytexture;
+		else
+		{
+			container_item *item = container->itemlist;
+			for (int itemnum = 0; itemnum < retained->itemindex; itemnum++)
+				item = item->next;
+			texture = item->texture;
+		}
+
+		/* same work as add_container_primitives, minus the geometry */
+		render_container_update_palette(container);
+		texture_get_scaled(texture, retained->dwidth, retained->dheight, &retained->prim->texture, &list->reflist);
+		if (retained->itemindex >= 0)
+			retained->prim->texture.palette = texture_get_adjusted_palette(texture, container);
+	}
+
+	osd_lock_release(list->lock);
+}
+
+
 
 /***************************************************************************
     RENDER REFERENCES
@@ -2695,6 +2916,27 @@ static int texture_get_scaled(render_texture *texture, UINT32 dwidth, UINT32 dhe
 }
 
 
+/*-------------------------------------------------
+    render_texture_get_source - return the source
+    bitmap of a texture along with the palette it
+    would be drawn with in the given container;
+    used by OSDs that present bitmaps directly
+-------------------------------------------------*/
+
+int render_texture_get_source(render_texture *texture, render_container *container, bitmap_t **bitmap, rectangle *sbounds, int *format, const rgb_t **palette)
+{
+	/* nothing to return until a bitmap has been set */
+	if (texture == NULL || texture->bitmap == NULL)
+		return FALSE;
+
+	*bitmap = texture->bitmap;
+	*sbounds = texture->sbounds;
+	*format = texture->format;
+	*palette = texture_get_adjusted_palette(texture, container);
+	return TRUE;
+}
+
+
 /*-------------------------------------------------
     render_texture_hq_scale - generic high quality
     resampling scaler
@@ -2926,6 +3168,27 @@ int render_container_is_empty(render_container *container)
 }
 
 
+/*-------------------------------------------------
+    render_container_is_texture_only - return true
+    if a container holds nothing but a single
+    unmodulated quad of the given texture and no
+    overlay
+-------------------------------------------------*/
+
+int render_container_is_texture_only(render_container *container, render_texture *texture)
+{
+	container_item *item = container->itemlist;
+
+	if (container->overlaytexture != NULL)
+		return FALSE;
+	if (item == NULL || item->next != NULL || item->type != CONTAINER_ITEM_QUAD || item->texture != texture)
+		return FALSE;
+
+	/* a tinted or faded quad must go through the normal render path */
+	return (item->color.r == 1.0f && item->color.g == 1.0f && item->color.b == 1.0f && item->color.a == 1.0f);
+}
+
+
 /*-------------------------------------------------
     render_container_get_user_settings - get the
     current user settings for a container
@@ -422,6 +422,9 @@ void render_texture_free(render_texture *texture);
 /* set a new source bitmap */
 void render_texture_set_bitmap(render_texture *texture, bitmap_t *bitmap, const rectangle *sbounds, int format, palette_t *palette);
 
+/* get the source bitmap and the palette it would be drawn with in a container */
+int render_texture_get_source(render_texture *texture, render_container *container, bitmap_t **bitmap, rectangle *sbounds, int *format, const rgb_t **palette);
+
 /* generic high quality resampling scaler */
 void render_texture_hq_scale(bitmap_t *dest, const bitmap_t *source, const rectangle *sbounds, void *param);
 
@@ -435,6 +438,9 @@ void render_container_empty(render_container *container);
 /* return true if a container has nothing in it */
 int render_container_is_empty(render_container *container);
 
+/* return true if a container holds nothing but a single opaque white quad of the given texture */
+int render_container_is_texture_only(render_container *container, render_texture *texture);
+
 /* get the current user settings for a container */
 void render_container_get_user_settings(render_container *container, render_container_user_settings *settings);
 
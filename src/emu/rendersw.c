@@ -54,6 +54,13 @@
 #include "video/rgbutil.h"
 #include "render.h"
 
+/* SIMD helpers for the unscaled rasterizers; same rules as rgbutil.h */
+#if (defined(__SSE2__) && defined(PTR64))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 
 /***************************************************************************
@@ -499,6 +506,22 @@ INLINE UINT32 get_texel_argb32_bilinear(const render_texinfo *texture, INT32 cur
 #endif
 #endif
 
+/* destination formats with a dedicated unscaled row converter */
+#undef DEST_IS_SOURCE32
+#undef DEST_IS_RGB565
+#define DEST_IS_SOURCE32	0
+#define DEST_IS_RGB565		0
+#ifndef VARIABLE_SHIFT
+#if (SRCSHIFT_R == 0) && (SRCSHIFT_G == 0) && (SRCSHIFT_B == 0) && (DSTSHIFT_R == 16) && (DSTSHIFT_G == 8) && (DSTSHIFT_B == 0)
+#undef DEST_IS_SOURCE32
+#define DEST_IS_SOURCE32	1
+#endif
+#if (SRCSHIFT_R == 3) && (SRCSHIFT_G == 2) && (SRCSHIFT_B == 3) && (DSTSHIFT_R == 11) && (DSTSHIFT_G == 5) && (DSTSHIFT_B == 0)
+#undef DEST_IS_RGB565
+#define DEST_IS_RGB565		1
+#endif
+#endif
+
 /* texel functions */
 #undef GET_TEXEL
 #define GET_TEXEL(type)				get_texel_##type##_##nearest
@@ -2215,6 +2238,196 @@ static void FUNC_PREFIX(draw_quad_argb32_add)(const render_primitive *prim, void
 
 
 
+/***************************************************************************
+    UNSCALED RASTERIZERS
+***************************************************************************/
+
+/*-------------------------------------------------
+    write_row_rgb32 - convert a row of 32bpp
+    MAME-format pixels into destination pixels
+-------------------------------------------------*/
+
+INLINE void FUNC_PREFIX(write_row_rgb32)(PIXEL_TYPE *dest, const UINT32 *src, INT32 count)
+{
+#if DEST_IS_SOURCE32
+	memcpy(dest, src, count * sizeof(*dest));
+#else
+	INT32 x = 0;
+
+#if DEST_IS_RGB565 && (defined(__SSE2__) && defined(PTR64))
+	const __m128i rmask = _mm_set1_epi32(0xf800);
+	const __m128i gmask = _mm_set1_epi32(0x07e0);
+	const __m128i bmask = _mm_set1_epi32(0x001f);
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i bias16 = _mm_set1_epi16((INT16)0x8000);
+
+	/* 8 pixels at a time; bias around zero so the signed pack can't saturate */
+	for ( ; x + 8 <= count; x += 8)
+	{
+		__m128i lo = _mm_loadu_si128((const __m128i *)&src[x + 0]);
+		__m128i hi = _mm_loadu_si128((const __m128i *)&src[x + 4]);
+		lo = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(lo, 8), rmask), _mm_and_si128(_mm_srli_epi32(lo, 5), gmask)), _mm_and_si128(_mm_srli_epi32(lo, 3), bmask));
+		hi = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(hi, 8), rmask), _mm_and_si128(_mm_srli_epi32(hi, 5), gmask)), _mm_and_si128(_mm_srli_epi32(hi, 3), bmask));
+		lo = _mm_packs_epi32(_mm_sub_epi32(lo, bias32), _mm_sub_epi32(hi, bias32));
+		_mm_storeu_si128((__m128i *)&dest[x], _mm_add_epi16(lo, bias16));
+	}
+#elif DEST_IS_RGB565 && defined(__ARM_NEON__)
+	const uint32x4_t rmask = vdupq_n_u32(0xf800);
+	const uint32x4_t gmask = vdupq_n_u32(0x07e0);
+	const uint32x4_t bmask = vdupq_n_u32(0x001f);
+
+	/* 8 pixels at a time */
+	for ( ; x + 8 <= count; x += 8)
+	{
+		uint32x4_t lo = vld1q_u32(&src[x + 0]);
+		uint32x4_t hi = vld1q_u32(&src[x + 4]);
+		lo = vorrq_u32(vorrq_u32(vandq_u32(vshrq_n_u32(lo, 8), rmask), vandq_u32(vshrq_n_u32(lo, 5), gmask)), vandq_u32(vshrq_n_u32(lo, 3), bmask));
+		hi = vorrq_u32(vorrq_u32(vandq_u32(vshrq_n_u32(hi, 8), rmask), vandq_u32(vshrq_n_u32(hi, 5), gmask)), vandq_u32(vshrq_n_u32(hi, 3), bmask));
+		vst1q_u16((uint16_t *)&dest[x], vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+	}
+#endif
+
+	/* whatever is left, one pixel at a time */
+	for ( ; x < count; x++)
+		dest[x] = SOURCE32_TO_DEST(src[x]);
+#endif
+}
+
+
+/*-------------------------------------------------
+    write_row_palette16 - look up a row of 16bpp
+    palettized pixels into destination pixels
+-------------------------------------------------*/
+
+INLINE void FUNC_PREFIX(write_row_palette16)(PIXEL_TYPE *dest, const UINT16 *src, const rgb_t *palbase, INT32 count)
+{
+	INT32 x = 0;
+
+#if DEST_IS_SOURCE32
+	/* lookup straight into the destination */
+	for ( ; x + 4 <= count; x += 4)
+	{
+		dest[x + 0] = palbase[src[x + 0]];
+		dest[x + 1] = palbase[src[x + 1]];
+		dest[x + 2] = palbase[src[x + 2]];
+		dest[x + 3] = palbase[src[x + 3]];
+	}
+	for ( ; x < count; x++)
+		dest[x] = palbase[src[x]];
+#else
+	/* lookup into a small staging buffer, then convert it in bulk */
+	UINT32 lookup[64];
+	while (x < count)
+	{
+		INT32 chunk = MIN(count - x, (INT32)ARRAY_LENGTH(lookup));
+		for (INT32 i = 0; i < chunk; i++)
+			lookup[i] = palbase[src[x + i]];
+		FUNC_PREFIX(write_row_rgb32)(dest + x, lookup, chunk);
+		x += chunk;
+	}
+#endif
+}
+
+
+/*-------------------------------------------------
+    write_row_rgb32_lut - convert a row of 32bpp
+    pixels through a 256-entry RGB lookup
+-------------------------------------------------*/
+
+INLINE void FUNC_PREFIX(write_row_rgb32_lut)(PIXEL_TYPE *dest, const UINT32 *src, const rgb_t *palbase, INT32 count)
+{
+	for (INT32 x = 0; x < count; x++)
+	{
+		UINT32 pix = src[x];
+		UINT32 r = palbase[(pix >> 16) & 0xff] >> SRCSHIFT_R;
+		UINT32 g = palbase[(pix >> 8) & 0xff] >> SRCSHIFT_G;
+		UINT32 b = palbase[(pix >> 0) & 0xff] >> SRCSHIFT_B;
+
+		dest[x] = DEST_ASSEMBLE_RGB(r, g, b);
+	}
+}
+
+
+/*-------------------------------------------------
+    draw_quad_palette16_unscaled - 1:1 copy of an
+    opaque, untinted 16bpp palettized texture;
+    brightness/contrast/gamma are already folded
+    into the adjusted palette
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_quad_palette16_unscaled)(const render_primitive *prim, void *dstdata, UINT32 pitch, quad_setup_data *setup)
+{
+	INT32 count = setup->endx - setup->startx;
+	const UINT16 *srcrow = (const UINT16 *)prim->texture.base + (setup->startv >> 16) * prim->texture.rowpixels + (setup->startu >> 16);
+
+	/* ensure all parameters are valid */
+	assert(prim->texture.palette != NULL);
+
+	/* loop over rows */
+	for (INT32 y = setup->starty; y < setup->endy; y++, srcrow += prim->texture.rowpixels)
+	{
+		PIXEL_TYPE *dest = (PIXEL_TYPE *)dstdata + y * pitch + setup->startx;
+		FUNC_PREFIX(write_row_palette16)(dest, srcrow, prim->texture.palette, count);
+	}
+}
+
+
+/*-------------------------------------------------
+    draw_quad_rgb32_unscaled - 1:1 copy of an
+    opaque, untinted 32bpp RGB texture
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_quad_rgb32_unscaled)(const render_primitive *prim, void *dstdata, UINT32 pitch, quad_setup_data *setup)
+{
+	const rgb_t *palbase = prim->texture.palette;
+	INT32 count = setup->endx - setup->startx;
+	const UINT32 *srcrow = (const UINT32 *)prim->texture.base + (setup->startv >> 16) * prim->texture.rowpixels + (setup->startu >> 16);
+
+	/* loop over rows */
+	for (INT32 y = setup->starty; y < setup->endy; y++, srcrow += prim->texture.rowpixels)
+	{
+		PIXEL_TYPE *dest = (PIXEL_TYPE *)dstdata + y * pitch + setup->startx;
+
+		/* no lookup case */
+		if (palbase == NULL)
+			FUNC_PREFIX(write_row_rgb32)(dest, srcrow, count);
+
+		/* lookup case */
+		else
+			FUNC_PREFIX(write_row_rgb32_lut)(dest, srcrow, palbase, count);
+	}
+}
+
+
+/*-------------------------------------------------
+    quad_is_unscaled - determine if a textured
+    quad maps texels 1:1 onto destination pixels
+    with no coloring or blending
+-------------------------------------------------*/
+
+INLINE int FUNC_PREFIX(quad_is_unscaled)(const render_primitive *prim, const quad_setup_data *setup)
+{
+	/* must be axis-aligned, unscaled and unrotated */
+	if (setup->dudx != 0x10000 || setup->dvdy != 0x10000 || setup->dvdx != 0 || setup->dudy != 0)
+		return FALSE;
+
+	/* must be opaque and untinted */
+	if (!IS_OPAQUE(prim->color.a) || prim->color.r < 1.0f || prim->color.g < 1.0f || prim->color.b < 1.0f)
+		return FALSE;
+
+	/* must not read outside the texture */
+	if (setup->startu < 0 || setup->startv < 0)
+		return FALSE;
+	if ((setup->startu >> 16) + (setup->endx - setup->startx) > prim->texture.width)
+		return FALSE;
+	if ((setup->startv >> 16) + (setup->endy - setup->starty) > prim->texture.height)
+		return FALSE;
+
+	return TRUE;
+}
+
+
+
 /***************************************************************************
     CORE QUAD RASTERIZERS
 ***************************************************************************/
@@ -2278,6 +2491,24 @@ static void FUNC_PREFIX(setup_and_draw_textured_quad)(const render_primitive *pr
 	setup.startu += (setup.dudx + setup.dudy) / 2;
 	setup.startv += (setup.dvdx + setup.dvdy) / 2;
 
+	/* native 1:1 case: straight copies, no U/V stepping */
+	if (FUNC_PREFIX(quad_is_unscaled)(prim, &setup))
+	{
+		switch (prim->flags & (PRIMFLAG_TEXFORMAT_MASK | PRIMFLAG_BLENDMODE_MASK))
+		{
+			case PRIMFLAG_TEXFORMAT(TEXFORMAT_PALETTE16) | PRIMFLAG_BLENDMODE(BLENDMODE_NONE):
+			case PRIMFLAG_TEXFORMAT(TEXFORMAT_PALETTE16) | PRIMFLAG_BLENDMODE(BLENDMODE_ALPHA):
+				FUNC_PREFIX(draw_quad_palette16_unscaled)(prim, dstdata, pitch, &setup);
+				return;
+
+			case PRIMFLAG_TEXFORMAT(TEXFORMAT_RGB32) | PRIMFLAG_BLENDMODE(BLENDMODE_NONE):
+			case PRIMFLAG_TEXFORMAT(TEXFORMAT_RGB32) | PRIMFLAG_BLENDMODE(BLENDMODE_ALPHA):
+			case PRIMFLAG_TEXFORMAT(TEXFORMAT_ARGB32) | PRIMFLAG_BLENDMODE(BLENDMODE_NONE):
+				FUNC_PREFIX(draw_quad_rgb32_unscaled)(prim, dstdata, pitch, &setup);
+				return;
+		}
+	}
+
 	/* render based on the texture coordinates */
 	switch (prim->flags & (PRIMFLAG_TEXFORMAT_MASK | PRIMFLAG_BLENDMODE_MASK))
 	{
@@ -2366,6 +2597,84 @@ static void FUNC_PREFIX(draw_primitives)(const render_primitive *primlist, void
 }
 
 
+/*-------------------------------------------------
+    draw_bitmap - copy a screen bitmap straight
+    to the destination, applying an orientation;
+    used by OSDs that bypass the render system
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_bitmap)(const bitmap_t *bitmap, const rectangle *sbounds, int format, const rgb_t *palbase, int orientation, void *dstdata, UINT32 pitch)
+{
+	INT32 width = sbounds->max_x - sbounds->min_x;
+	INT32 height = sbounds->max_y - sbounds->min_y;
+	INT32 dstwidth = (orientation & ORIENTATION_SWAP_XY) ? height : width;
+	INT32 dstheight = (orientation & ORIENTATION_SWAP_XY) ? width : height;
+	INT32 xstep, ystep;
+
+	assert(format == TEXFORMAT_PALETTE16 || format == TEXFORMAT_RGB32);
+	assert(format != TEXFORMAT_PALETTE16 || palbase != NULL);
+
+	/* unrotated case: whole rows at a time */
+	if ((orientation & ORIENTATION_MASK) == ROT0)
+	{
+		for (INT32 y = 0; y < height; y++)
+		{
+			PIXEL_TYPE *dest = (PIXEL_TYPE *)dstdata + y * pitch;
+
+			if (format == TEXFORMAT_PALETTE16)
+				FUNC_PREFIX(write_row_palette16)(dest, BITMAP_ADDR16(bitmap, sbounds->min_y + y, sbounds->min_x), palbase, width);
+			else if (palbase == NULL)
+				FUNC_PREFIX(write_row_rgb32)(dest, BITMAP_ADDR32(bitmap, sbounds->min_y + y, sbounds->min_x), width);
+			else
+				FUNC_PREFIX(write_row_rgb32_lut)(dest, BITMAP_ADDR32(bitmap, sbounds->min_y + y, sbounds->min_x), palbase, width);
+		}
+		return;
+	}
+
+	/* otherwise, walk the source in order and step through the destination */
+	PIXEL_TYPE *origin = (PIXEL_TYPE *)dstdata;
+	if (orientation & ORIENTATION_FLIP_X)
+		origin += dstwidth - 1;
+	if (orientation & ORIENTATION_FLIP_Y)
+		origin += (dstheight - 1) * pitch;
+
+	if (orientation & ORIENTATION_SWAP_XY)
+	{
+		xstep = (orientation & ORIENTATION_FLIP_Y) ? -(INT32)pitch : (INT32)pitch;
+		ystep = (orientation & ORIENTATION_FLIP_X) ? -1 : 1;
+	}
+	else
+	{
+		xstep = (orientation & ORIENTATION_FLIP_X) ? -1 : 1;
+		ystep = (orientation & ORIENTATION_FLIP_Y) ? -(INT32)pitch : (INT32)pitch;
+	}
+
+	for (INT32 y = 0; y < height; y++, origin += ystep)
+	{
+		PIXEL_TYPE *dest = origin;
+
+		if (format == TEXFORMAT_PALETTE16)
+		{
+			const UINT16 *src = BITMAP_ADDR16(bitmap, sbounds->min_y + y, sbounds->min_x);
+			for (INT32 x = 0; x < width; x++, dest += xstep)
+				*dest = SOURCE32_TO_DEST(palbase[src[x]]);
+		}
+		else if (palbase == NULL)
+		{
+			const UINT32 *src = BITMAP_ADDR32(bitmap, sbounds->min_y + y, sbounds->min_x);
+			for (INT32 x = 0; x < width; x++, dest += xstep)
+				*dest = SOURCE32_TO_DEST(src[x]);
+		}
+		else
+		{
+			const UINT32 *src = BITMAP_ADDR32(bitmap, sbounds->min_y + y, sbounds->min_x);
+			for (INT32 x = 0; x < width; x++, dest += xstep)
+				FUNC_PREFIX(write_row_rgb32_lut)(dest, &src[x], palbase, 1);
+		}
+	}
+}
+
+
 
 /***************************************************************************
     MACRO UNDOING
@@ -2389,6 +2698,9 @@ static void FUNC_PREFIX(draw_primitives)(const render_primitive *primlist, void
 #undef SOURCE15_TO_DEST
 #undef SOURCE32_TO_DEST
 
+#undef DEST_IS_SOURCE32
+#undef DEST_IS_RGB565
+
 #undef FUNC_PREFIX
 #undef PIXEL_TYPE
 
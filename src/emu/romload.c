@@ -16,12 +16,17 @@
 #include "harddisk.h"
 #include "config.h"
 #include "ui.h"
+#include <zlib.h>
 
 
 #define LOG_LOAD	0
 #define LOG(x)		do { if (LOG_LOAD) debugload x; } while(0)
 
 extern bool verify_rom_hash;
+extern bool verify_rom_zip_crc;
+extern bool cache_decrypted_roms;
+extern bool cache_rom_audit;
+extern bool cache_rom_regions;
 
 /***************************************************************************
     CONSTANTS
@@ -29,6 +34,16 @@ extern bool verify_rom_hash;
 
 #define TEMPBUFFER_MAX_SIZE		(1024 * 1024 * 1024)
 
+/* the region cache keeps a second copy of the ROMs; past this many bytes
+   the remaining regions and stages are loaded the usual way each time */
+#define REGION_CACHE_MAX_SIZE	(64 * 1024 * 1024)
+
+/* decrypted data cache files live here, under the NVRAM path */
+#define ROM_CACHE_DIRECTORY		"mba-cache"
+
+static const char rom_cache_magic[8] = { 'M', 'B', 'A', 'D', 'C', 'R', '1', 0 };
+static const char rom_audit_magic[8] = { 'M', 'B', 'A', 'A', 'U', 'D', '1', 0 };
+
 
 
 /***************************************************************************
@@ -47,6 +62,29 @@ struct _open_chd
 };
 
 
+typedef struct _rom_prefetch rom_prefetch;
+struct _rom_prefetch
+{
+	const rom_entry *	romp;			/* entry the file was opened for, NULL once taken */
+	mame_file *			file;			/* file being inflated */
+	osd_work_item *		item;			/* work item inflating it */
+};
+
+
+/* a loaded region or a decryption stage output, kept in memory between machines */
+typedef struct _region_cache_entry region_cache_entry;
+struct _region_cache_entry
+{
+	region_cache_entry *	next;		/* pointer to next in the list */
+	osd_file *		file;			/* in-memory file holding the data */
+	int				decrypted;		/* TRUE for the output of a decryption stage */
+	UINT32			length;			/* length of the data */
+	UINT32			flags;			/* region flags */
+	UINT32			hash;			/* CRC over the files the data came from */
+	char			tag[1];			/* region tag or stage name */
+};
+
+
 typedef struct _romload_private rom_load_data;
 struct _romload_private
 {
@@ -60,6 +98,9 @@ struct _romload_private
 	int				romstotal;	/* total number of ROMs to read */
 	UINT32				romsloadedsize;	/* total size of ROMs loaded so far */
 	UINT32				romstotalsize;	/* total size of ROMs to read */
+	UINT32				sethash;	/* CRC over the ROMs loaded, keys the decrypted data cache */
+	int				audited;	/* same files as the last clean verification; only the zip CRCs are compared */
+	int				unkeyed;	/* a loose file the set hash cannot vouch for; no caching */
 
 	mame_file		*file;			/* current file */
 	open_chd		*chd_list;		/* disks */
@@ -67,6 +108,10 @@ struct _romload_private
 
 	region_info		*region;		/* info about current region */
 
+	osd_work_queue	*queue;			/* queue inflating the files of a region ahead of the loader */
+	rom_prefetch	*prefetch;		/* files of the current region being inflated */
+	int				prefetchcount;	/* number of entries in the prefetch list */
+
 	astring				errorstring;	/* error string */
 };
 
@@ -76,6 +121,23 @@ struct _romload_private
 ***************************************************************************/
 
 static void rom_exit(running_machine &machine);
+static int rom_audit_load(rom_load_data *romdata);
+static void rom_audit_save(rom_load_data *romdata);
+static void region_cache_begin(running_machine *machine);
+static region_cache_entry *region_cache_find(int decrypted, const char *tag, UINT32 length, UINT32 flags, UINT32 hash);
+static void region_cache_store(int decrypted, const char *tag, UINT32 length, UINT32 flags, UINT32 hash, const void *data);
+static void region_cache_flush(void);
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+/* the region cache only ever holds data of one driver */
+static const game_driver *region_cache_driver;
+static region_cache_entry *region_cache_list;
+static UINT32 region_cache_size;		/* bytes held by the entries */
 
 
 
@@ -520,15 +582,30 @@ static void dump_wrong_and_correct_checksums(rom_load_data *romdata, const char
 static void verify_length_and_hash(rom_load_data *romdata, const char *name, UINT32 explength, const char *hash)
 {
 	UINT32 actlength;
+	UINT32 functions = hash_data_used_functions(hash);
+	int skipcheck = FALSE;
 	const char* acthash;
 
 	/* we've already complained if there is no file */
 	if (romdata->file == NULL)
 		return;
 
+	/* a set that verified clean with the same files last time only compares the CRC of the
+       data inflated from a zip, which costs nothing extra, and trusts its loose files by size
+       and modification time; otherwise a matching CRC from the zip (checked while inflating)
+       can stand in for the full hash, while loose files and mismatches still get every
+       checksum computed */
+	if (romdata->audited)
+	{
+		functions = mame_file_is_zipped(romdata->file) ? HASH_CRC : 0;
+		skipcheck = (functions == 0);
+	}
+	else if (verify_rom_zip_crc && hash_data_is_equal(hash, mame_fhash(romdata->file, 0), HASH_CRC) == 1)
+		functions = HASH_CRC;
+
 	/* get the length and CRC from the file */
 	actlength = mame_fsize(romdata->file);
-	acthash = mame_fhash(romdata->file, hash_data_used_functions(hash));
+	acthash = mame_fhash(romdata->file, functions);
 
 	/* verify length */
 	if (explength != actlength)
@@ -552,7 +629,7 @@ static void verify_length_and_hash(rom_load_data *romdata, const char *name, UIN
 	}
 	/* verify checksums */
 	else
-	if (!hash_data_is_equal(hash, acthash, 0))
+	if (!skipcheck && !hash_data_is_equal(hash, acthash, romdata->audited ? HASH_CRC : 0))
 	{
 		/* otherwise, it's just bad */
 		romdata->errorstring.catprintf("%s WRONG CHECKSUMS:\n", name);
@@ -626,6 +703,7 @@ static void display_rom_load_results(rom_load_data *romdata)
 static void region_post_process(rom_load_data *romdata, const char *rgntag)
 {
 	const region_info *region = romdata->machine->region(rgntag);
+	startup_trace_scope trace("rom.postprocess", rgntag);
 	UINT8 *base;
 	int i, j;
 
@@ -660,22 +738,18 @@ static void region_post_process(rom_load_data *romdata, const char *rgntag)
 
 
 /*-------------------------------------------------
-    open_rom_file - open a ROM file, searching
+    find_rom_file - open a ROM file, searching
     up the parent and loading by checksum
 -------------------------------------------------*/
 
-static int open_rom_file(rom_load_data *romdata, const char *regiontag, const rom_entry *romp)
+static file_error find_rom_file(rom_load_data *romdata, const char *regiontag, const rom_entry *romp, UINT32 openflags, mame_file **file)
 {
 	file_error filerr = FILERR_NOT_FOUND;
-	UINT32 romsize = rom_file_size(romp);
 	const game_driver *drv;
 	int has_crc = FALSE;
 	UINT8 crcbytes[4];
 	UINT32 crc = 0;
 
-	/* update status display */
-	display_loading_rom_message(romdata, ROM_GETNAME(romp));
-
 	/* extract CRC to use for searching */
 	has_crc = hash_data_extract_binary_checksum(ROM_GETHASHDATA(romp), HASH_CRC, crcbytes);
 	if (has_crc)
@@ -683,25 +757,155 @@ static int open_rom_file(rom_load_data *romdata, const char *regiontag, const ro
 
 	/* attempt reading up the chain through the parents. It automatically also
        attempts any kind of load by checksum supported by the archives. */
-	romdata->file = NULL;
-	for (drv = romdata->machine->gamedrv; romdata->file == NULL && drv != NULL; drv = driver_get_clone(drv))
+	*file = NULL;
+	for (drv = romdata->machine->gamedrv; *file == NULL && drv != NULL; drv = driver_get_clone(drv))
 		if (drv->name != NULL && *drv->name != 0)
 		{
 			astring fname(drv->name, PATH_SEPARATOR, ROM_GETNAME(romp));
 			if (has_crc)
-				filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, OPEN_FLAG_READ, &romdata->file);
+				filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, openflags, file);
 			else
-				filerr = mame_fopen(SEARCHPATH_ROM, fname, OPEN_FLAG_READ, &romdata->file);
+				filerr = mame_fopen(SEARCHPATH_ROM, fname, openflags, file);
 		}
 
 	/* if the region is load by name, load the ROM from there */
-	if (romdata->file == NULL && regiontag != NULL)
+	if (*file == NULL && regiontag != NULL)
 	{
 		astring fname(regiontag, PATH_SEPARATOR, ROM_GETNAME(romp));
 		if (has_crc)
-			filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, OPEN_FLAG_READ, &romdata->file);
+			filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, openflags, file);
 		else
-			filerr = mame_fopen(SEARCHPATH_ROM, fname, OPEN_FLAG_READ, &romdata->file);
+			filerr = mame_fopen(SEARCHPATH_ROM, fname, openflags, file);
+	}
+	return filerr;
+}
+
+
+/*-------------------------------------------------
+    prefetch_rom_work - inflate one file on the
+    work queue
+-------------------------------------------------*/
+
+static void *prefetch_rom_work(void *param, int threadid)
+{
+	rom_prefetch *prefetch = (rom_prefetch *)param;
+	startup_trace_scope trace("rom.inflate", ROM_GETNAME(prefetch->romp), threadid + 1);
+
+	mame_fpreload(prefetch->file);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    prefetch_rom_files - open every file of a
+    region and start inflating them in parallel,
+    ahead of the loader working through them
+-------------------------------------------------*/
+
+static void prefetch_rom_files(rom_load_data *romdata, const char *regiontag, const rom_entry *romp)
+{
+	const rom_entry *entry;
+	int count = 0;
+
+	romdata->prefetch = NULL;
+	romdata->prefetchcount = 0;
+	if (romdata->queue == NULL)
+		return;
+
+	for (entry = romp; !ROMENTRY_ISREGIONEND(entry); entry++)
+		if (ROMENTRY_ISFILE(entry))
+			count++;
+	if (count == 0)
+		return;
+
+	romdata->prefetch = auto_alloc_array_clear(romdata->machine, rom_prefetch, count);
+	for (entry = romp; !ROMENTRY_ISREGIONEND(entry); entry++)
+		if (ROMENTRY_ISFILE(entry) && (ROM_GETBIOSFLAGS(entry) == 0 || ROM_GETBIOSFLAGS(entry) == romdata->system_bios))
+		{
+			rom_prefetch *prefetch = &romdata->prefetch[romdata->prefetchcount++];
+
+			startup_trace_scope trace("rom.open", ROM_GETNAME(entry));
+
+			prefetch->romp = entry;
+			if (find_rom_file(romdata, regiontag, entry, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD, &prefetch->file) == FILERR_NONE)
+				prefetch->item = osd_work_item_queue(romdata->queue, prefetch_rom_work, prefetch, 0);
+		}
+}
+
+
+/*-------------------------------------------------
+    take_prefetched_file - wait for the file
+    prefetched for an entry and take it over
+-------------------------------------------------*/
+
+static mame_file *take_prefetched_file(rom_load_data *romdata, const rom_entry *romp)
+{
+	int prefnum;
+
+	for (prefnum = 0; prefnum < romdata->prefetchcount; prefnum++)
+	{
+		rom_prefetch *prefetch = &romdata->prefetch[prefnum];
+
+		if (prefetch->romp == romp)
+		{
+			if (prefetch->item != NULL)
+				osd_work_item_release(prefetch->item);
+			prefetch->romp = NULL;
+			prefetch->item = NULL;
+			return prefetch->file;
+		}
+	}
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    end_prefetch - close anything the loader did
+    not take and drop the prefetch list
+-------------------------------------------------*/
+
+static void end_prefetch(rom_load_data *romdata)
+{
+	int prefnum;
+
+	for (prefnum = 0; prefnum < romdata->prefetchcount; prefnum++)
+	{
+		rom_prefetch *prefetch = &romdata->prefetch[prefnum];
+
+		if (prefetch->romp == NULL)
+			continue;
+		if (prefetch->item != NULL)
+			osd_work_item_release(prefetch->item);
+		if (prefetch->file != NULL)
+			mame_fclose(prefetch->file);
+	}
+	if (romdata->prefetch != NULL)
+		auto_free(romdata->machine, romdata->prefetch);
+	romdata->prefetch = NULL;
+	romdata->prefetchcount = 0;
+}
+
+
+/*-------------------------------------------------
+    open_rom_file - open a ROM file, taking it
+    from the prefetch list if it was opened
+    ahead of time
+-------------------------------------------------*/
+
+static int open_rom_file(rom_load_data *romdata, const char *regiontag, const rom_entry *romp)
+{
+	file_error filerr = FILERR_NONE;
+	UINT32 romsize = rom_file_size(romp);
+
+	/* update status display */
+	display_loading_rom_message(romdata, ROM_GETNAME(romp));
+
+	/* files that failed to prefetch get another search here */
+	romdata->file = take_prefetched_file(romdata, romp);
+	if (romdata->file == NULL)
+	{
+		startup_trace_scope trace("rom.open", ROM_GETNAME(romp));
+		filerr = find_rom_file(romdata, regiontag, romp, OPEN_FLAG_READ, &romdata->file);
 	}
 
 	/* update counters */
@@ -713,6 +917,52 @@ static int open_rom_file(rom_load_data *romdata, const char *regiontag, const ro
 }
 
 
+/*-------------------------------------------------
+    add_to_set_hash - fold a ROM and the file
+    opened for it into the hash that keys the
+    decrypted data, audit and region caches
+-------------------------------------------------*/
+
+static UINT32 add_to_set_hash(rom_load_data *romdata, UINT32 crc, const rom_entry *romp, mame_file *file)
+{
+	const char *hash = ROM_GETHASHDATA(romp);
+
+	crc = crc32(crc, (const UINT8 *)ROM_GETNAME(romp), strlen(ROM_GETNAME(romp)));
+	crc = crc32(crc, (const UINT8 *)hash, strlen(hash));
+
+	if (file != NULL)
+	{
+		UINT32 length = mame_fsize(file);
+
+		crc = crc32(crc, (const UINT8 *)&length, sizeof(length));
+
+		/* zipped files already know their CRC from the central directory */
+		if (mame_file_is_zipped(file))
+		{
+			const char *acthash = mame_fhash(file, 0);
+			crc = crc32(crc, (const UINT8 *)acthash, strlen(acthash));
+		}
+
+		/* loose files have no checksum until they are read; key them by size and modification time */
+		else
+		{
+			osd_directory_entry *entry = osd_stat(mame_file_full_name(file));
+
+			if (entry != NULL && entry->modified != 0)
+			{
+				crc = crc32(crc, (const UINT8 *)&entry->size, sizeof(entry->size));
+				crc = crc32(crc, (const UINT8 *)&entry->modified, sizeof(entry->modified));
+			}
+			else
+				romdata->unkeyed = TRUE;
+			if (entry != NULL)
+				osd_free(entry);
+		}
+	}
+	return crc;
+}
+
+
 /*-------------------------------------------------
     rom_fread - cheesy fread that fills with
     random data for a NULL file
@@ -732,6 +982,36 @@ static int rom_fread(rom_load_data *romdata, UINT8 *buffer, int length)
 }
 
 
+/*-------------------------------------------------
+    map_rom_data - use the mapped file as the
+    region itself when it fills the region and
+    needs no post-processing
+-------------------------------------------------*/
+
+static int map_rom_data(rom_load_data *romdata, int length)
+{
+	region_info *region = romdata->region;
+	void *base;
+
+	if (romdata->file == NULL || length != region->bytes())
+		return FALSE;
+	if (mame_ftell(romdata->file) != 0 || mame_fsize(romdata->file) != length)
+		return FALSE;
+	if (region->invert() || (region->width() > 1 && region->endianness() != ENDIANNESS_NATIVE))
+		return FALSE;
+
+	/* loose files and stored zip entries only; the pages are shared until written */
+	base = mame_fmap(romdata->file);
+	if (base == NULL)
+		return FALSE;
+
+	LOG(("  Mapping %X bytes @ %p\n", length, base));
+	region->map(base);
+	mame_fseek(romdata->file, length, SEEK_SET);
+	return TRUE;
+}
+
+
 /*-------------------------------------------------
     read_rom_data - read ROM data for a single
     entry
@@ -767,7 +1047,11 @@ static int read_rom_data(rom_load_data *romdata, const rom_entry *romp)
 
 	/* special case for simple loads */
 	if (datamask == 0xff && (groupsize == 1 || !reversed) && skip == 0)
+	{
+		if (ROM_GETOFFSET(romp) == 0 && map_rom_data(romdata, numbytes))
+			return numbytes;
 		return rom_fread(romdata, base, numbytes);
+	}
 
 	/* use a temporary buffer for complex loads */
 	tempbufsize = MIN(TEMPBUFFER_MAX_SIZE, numbytes);
@@ -917,6 +1201,9 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 {
 	UINT32 lastflags = 0;
 
+	/* get the whole region inflating while we copy in order */
+	prefetch_rom_files(romdata, regiontag, romp);
+
 	/* loop until we hit the end of this region */
 	while (!ROMENTRY_ISREGIONEND(romp))
 	{
@@ -946,11 +1233,14 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 			int irrelevantbios = (ROM_GETBIOSFLAGS(romp) != 0 && ROM_GETBIOSFLAGS(romp) != romdata->system_bios);
 			const rom_entry *baserom = romp;
 			int explength = 0;
+			startup_trace_scope trace("rom.load", ROM_GETNAME(romp));
 
 			/* open the file if it is a non-BIOS or matches the current BIOS */
 			LOG(("Opening ROM file: %s\n", ROM_GETNAME(romp)));
 			if (!irrelevantbios && !open_rom_file(romdata, regiontag, romp))
 				handle_missing_file(romdata, romp);
+			if (!irrelevantbios)
+				romdata->sethash = add_to_set_hash(romdata, romdata->sethash, romp, romdata->file);
 
 			/* loop until we run out of reloads */
 			do
@@ -978,6 +1268,8 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 				/* if this was the first use of this file, verify the length and CRC */
 				if (baserom && verify_rom_hash)
 				{
+					startup_trace_scope trace("rom.hash", ROM_GETNAME(baserom));
+
 					LOG(("Verifying length (%X) and checksums\n", explength));
 					verify_length_and_hash(romdata, ROM_GETNAME(baserom), explength, ROM_GETHASHDATA(baserom));
 					LOG(("Verify finished\n"));
@@ -1004,6 +1296,7 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 			romp++;	/* something else; skip */
 		}
 	}
+	end_prefetch(romdata);
 }
 
 
@@ -1356,6 +1649,43 @@ void load_software_part_region(running_device *device, char *swlist, char *swnam
 }
 
 
+/*-------------------------------------------------
+    hash_region_files - open every file a region
+    will load, without reading them, and fold
+    them into both the region and the set hash;
+    returns FALSE if the region contents depend
+    on anything else
+-------------------------------------------------*/
+
+static int hash_region_files(rom_load_data *romdata, const char *regiontag, const rom_entry *romp, UINT32 *regionhash, UINT32 *sethash)
+{
+	int complete = TRUE;
+
+	for ( ; !ROMENTRY_ISREGIONEND(romp); romp++)
+	{
+		/* copies pull in data from another region */
+		if (ROMENTRY_ISCOPY(romp))
+			complete = FALSE;
+
+		else if (ROMENTRY_ISFILE(romp) && (ROM_GETBIOSFLAGS(romp) == 0 || ROM_GETBIOSFLAGS(romp) == romdata->system_bios))
+		{
+			mame_file *file = NULL;
+
+			if (find_rom_file(romdata, regiontag, romp, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD, &file) != FILERR_NONE)
+			{
+				file = NULL;
+				complete = FALSE;
+			}
+			*regionhash = add_to_set_hash(romdata, *regionhash, romp, file);
+			*sethash = add_to_set_hash(romdata, *sethash, romp, file);
+			if (file != NULL)
+				mame_fclose(file);
+		}
+	}
+	return complete && !romdata->unkeyed;
+}
+
+
 /*-------------------------------------------------
     process_region_list - process a region list
 -------------------------------------------------*/
@@ -1381,6 +1711,12 @@ static void process_region_list(rom_load_data *romdata)
 
 			if (ROMREGION_ISROMDATA(region))
 			{
+				const char *loadtag = ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL;
+				int warnings = romdata->warnings, errors = romdata->errors;
+				UINT32 sethash = romdata->sethash;
+				UINT32 regionhash = 0;
+				int cacheable = FALSE;
+
 				/* if this is a device region, override with the device width and endianness */
 				if (romdata->machine->device(regiontag) != NULL)
 					regionflags = normalize_flags_for_device(romdata->machine, regionflags, regiontag);
@@ -1389,6 +1725,26 @@ static void process_region_list(rom_load_data *romdata)
 				romdata->region = romdata->machine->region_alloc(regiontag, regionlength, regionflags);
 				LOG(("Allocated %X bytes @ %p\n", romdata->region->bytes(), romdata->region->base()));
 
+				/* if the last machine loaded this region from the same files, take its pages copy-on-write */
+				if (cache_rom_regions)
+				{
+					region_cache_entry *entry;
+
+					cacheable = hash_region_files(romdata, loadtag, region + 1, &regionhash, &sethash);
+					entry = cacheable ? region_cache_find(FALSE, regiontag, regionlength, regionflags, regionhash) : NULL;
+					if (entry != NULL)
+					{
+						void *base = osd_map(entry->file, 0, regionlength);
+						if (base != NULL)
+						{
+							LOG(("Mapping cached region @ %p\n", base));
+							romdata->region->map(base);
+							romdata->sethash = sethash;
+							continue;
+						}
+					}
+				}
+
 				/* clear the region if it's requested */
 				if (ROMREGION_ISERASE(region))
 					memset(romdata->region->base(), ROMREGION_GETERASEVAL(region), romdata->region->bytes());
@@ -1404,7 +1760,11 @@ static void process_region_list(rom_load_data *romdata)
 #endif
 
 				/* now process the entries in the region */
-				process_rom_entries(romdata, ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL, region + 1);
+				process_rom_entries(romdata, loadtag, region + 1);
+
+				/* keep a region that loaded cleanly for the next machine; it is stored before post-processing, like the files */
+				if (cacheable && romdata->warnings == warnings && romdata->errors == errors)
+					region_cache_store(FALSE, regiontag, regionlength, regionflags, regionhash, romdata->region->base());
 			}
 			else if (ROMREGION_ISDISKDATA(region))
 				process_disk_entries(romdata, ROMREGION_GETTAG(region), region + 1);
@@ -1417,6 +1777,30 @@ static void process_region_list(rom_load_data *romdata)
 }
 
 
+/*-------------------------------------------------
+    compute_set_hash - open every file the set
+    will load, without reading them, and compute
+    the hash the loader will arrive at
+-------------------------------------------------*/
+
+static UINT32 compute_set_hash(rom_load_data *romdata)
+{
+	const rom_source *source;
+	const rom_entry *region;
+	UINT32 crc = 0;
+
+	for (source = rom_first_source(romdata->machine->gamedrv, romdata->machine->config); source != NULL; source = rom_next_source(romdata->machine->gamedrv, romdata->machine->config, source))
+		for (region = rom_first_region(romdata->machine->gamedrv, source); region != NULL; region = rom_next_region(region))
+			if (ROMREGION_ISROMDATA(region))
+			{
+				UINT32 regionhash = 0;
+
+				hash_region_files(romdata, ROMREGION_ISLOADBYNAME(region) ? ROMREGION_GETTAG(region) : NULL, region + 1, &regionhash, &crc);
+			}
+	return crc;
+}
+
+
 /*-------------------------------------------------
     rom_init - load the ROMs and open the disk
     images associated with the given machine
@@ -1445,8 +1829,22 @@ void rom_init(running_machine *machine)
 	romdata->chd_list = NULL;
 	romdata->chd_list_tailptr = &machine->romload_data->chd_list;
 
-	/* process the ROM entries we were passed */
+	/* skip the checksums if the files are the ones that verified clean last time */
+	romdata->audited = rom_audit_load(romdata);
+
+	/* drop what an earlier machine left in memory unless it ran the same set */
+	region_cache_begin(machine);
+
+	/* process the ROM entries we were passed, inflating files on all CPUs */
+	romdata->queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
 	process_region_list(romdata);
+	if (romdata->queue != NULL)
+		osd_work_queue_free(romdata->queue);
+	romdata->queue = NULL;
+
+	/* remember a set that just verified clean */
+	if (!romdata->audited)
+		rom_audit_save(romdata);
 
 	/* display the results and exit */
 	display_rom_load_results(romdata);
@@ -1485,3 +1883,319 @@ int rom_load_warnings(running_machine *machine)
 {
 	return machine->romload_data->warnings;
 }
+
+
+
+/***************************************************************************
+    DECRYPTED DATA CACHE
+***************************************************************************/
+
+/*-------------------------------------------------
+    rom_cache_usable - return TRUE if the loaded
+    ROMs can key the decrypted data cache
+-------------------------------------------------*/
+
+static int rom_cache_usable(running_machine *machine)
+{
+	rom_load_data *romdata = machine->romload_data;
+
+	/* missing or mismatched ROMs, or loose files without a modification time, make the set hash meaningless */
+	return romdata->errors == 0 && romdata->warnings == 0 && !romdata->unkeyed;
+}
+
+
+/*-------------------------------------------------
+    rom_cache_open - open the cache file for one
+    decryption stage of the running set
+-------------------------------------------------*/
+
+static mame_file *rom_cache_open(running_machine *machine, const char *stage, UINT32 openflags)
+{
+	astring fname(ROM_CACHE_DIRECTORY PATH_SEPARATOR, machine->basename(), "-", stage, ".dcr");
+	mame_file *file;
+
+	if (mame_fopen(SEARCHPATH_NVRAM, fname, openflags, &file) != FILERR_NONE)
+		return NULL;
+	return file;
+}
+
+
+/*-------------------------------------------------
+    rom_cache_load - fill a buffer with the saved
+    output of a load-time decryption stage
+-------------------------------------------------*/
+
+int rom_cache_load(running_machine *machine, const char *stage, void *buffer, UINT32 length)
+{
+	UINT8 header[16];
+	mame_file *file;
+	int valid;
+
+	if (!rom_cache_usable(machine))
+		return FALSE;
+
+	/* a copy left in memory by the last machine running this set comes first */
+	if (cache_rom_regions)
+	{
+		region_cache_entry *entry = region_cache_find(TRUE, stage, length, 0, machine->romload_data->sethash);
+		UINT32 actual;
+
+		if (entry != NULL && osd_read(entry->file, buffer, 0, length, &actual) == FILERR_NONE && actual == length)
+			return TRUE;
+	}
+
+	if (!cache_decrypted_roms)
+		return FALSE;
+	file = rom_cache_open(machine, stage, OPEN_FLAG_READ);
+	if (file == NULL)
+		return FALSE;
+
+	/* the header holds the magic, the set hash and the length */
+	valid = (mame_fsize(file) == sizeof(header) + length && mame_fread(file, header, sizeof(header)) == sizeof(header) &&
+		memcmp(&header[0], rom_cache_magic, sizeof(rom_cache_magic)) == 0 &&
+		memcmp(&header[8], &machine->romload_data->sethash, 4) == 0 && memcmp(&header[12], &length, 4) == 0);
+
+	/* past this point the caller's buffer is no longer intact */
+	if (valid && mame_fread(file, buffer, length) != length)
+		fatalerror("Error reading decrypted data cache for %s\n", stage);
+	mame_fclose(file);
+
+	LOG(("Decrypted data cache %s: %s\n", stage, valid ? "hit" : "stale"));
+	if (valid && cache_rom_regions)
+		region_cache_store(TRUE, stage, length, 0, machine->romload_data->sethash, buffer);
+	return valid;
+}
+
+
+/*-------------------------------------------------
+    rom_cache_save - store the output of a
+    load-time decryption stage
+-------------------------------------------------*/
+
+void rom_cache_save(running_machine *machine, const char *stage, const void *buffer, UINT32 length)
+{
+	UINT8 header[16];
+	mame_file *file;
+
+	if (!rom_cache_usable(machine))
+		return;
+	if (cache_rom_regions)
+		region_cache_store(TRUE, stage, length, 0, machine->romload_data->sethash, buffer);
+
+	if (!cache_decrypted_roms)
+		return;
+	file = rom_cache_open(machine, stage, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file == NULL)
+		return;
+
+	memcpy(&header[0], rom_cache_magic, sizeof(rom_cache_magic));
+	memcpy(&header[8], &machine->romload_data->sethash, 4);
+	memcpy(&header[12], &length, 4);
+
+	/* a short write leaves a file that fails the length check on the next boot */
+	if (mame_fwrite(file, header, sizeof(header)) == sizeof(header))
+		mame_fwrite(file, buffer, length);
+	mame_fclose(file);
+}
+
+
+
+/***************************************************************************
+    AUDIT CACHE
+***************************************************************************/
+
+/*-------------------------------------------------
+    rom_audit_open - open the file remembering
+    the last clean verification of the set
+-------------------------------------------------*/
+
+static mame_file *rom_audit_open(rom_load_data *romdata, UINT32 openflags)
+{
+	astring fname(ROM_CACHE_DIRECTORY PATH_SEPARATOR, romdata->machine->basename(), ".aud");
+	mame_file *file;
+
+	if (mame_fopen(SEARCHPATH_NVRAM, fname, openflags, &file) != FILERR_NONE)
+		return NULL;
+	return file;
+}
+
+
+/*-------------------------------------------------
+    rom_audit_load - return TRUE if the set was
+    verified clean last time with the files that
+    are there now
+-------------------------------------------------*/
+
+static int rom_audit_load(rom_load_data *romdata)
+{
+	startup_trace_scope trace("rom.audit", "rom_audit_load");
+	UINT8 header[12];
+	UINT32 sethash;
+	mame_file *file;
+	int valid;
+
+	if (!cache_rom_audit || !verify_rom_hash)
+		return FALSE;
+	file = rom_audit_open(romdata, OPEN_FLAG_READ);
+	if (file == NULL)
+		return FALSE;
+	valid = (mame_fread(file, header, sizeof(header)) == sizeof(header) && memcmp(&header[0], rom_audit_magic, sizeof(rom_audit_magic)) == 0);
+	mame_fclose(file);
+	if (!valid)
+		return FALSE;
+
+	/* opening the files is cheap next to checksumming them */
+	sethash = compute_set_hash(romdata);
+	valid = (!romdata->unkeyed && memcmp(&header[8], &sethash, 4) == 0);
+
+	LOG(("Audit cache: %s\n", valid ? "hit" : "stale"));
+	return valid;
+}
+
+
+/*-------------------------------------------------
+    rom_audit_save - remember a clean
+    verification of the set
+-------------------------------------------------*/
+
+static void rom_audit_save(rom_load_data *romdata)
+{
+	UINT8 header[12];
+	mame_file *file;
+
+	if (!cache_rom_audit || !verify_rom_hash || romdata->errors != 0 || romdata->warnings != 0 || romdata->unkeyed)
+		return;
+	file = rom_audit_open(romdata, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file == NULL)
+		return;
+
+	memcpy(&header[0], rom_audit_magic, sizeof(rom_audit_magic));
+	memcpy(&header[8], &romdata->sethash, 4);
+	mame_fwrite(file, header, sizeof(header));
+	mame_fclose(file);
+}
+
+
+
+/***************************************************************************
+    REGION CACHE
+***************************************************************************/
+
+/*-------------------------------------------------
+    region_cache_begin - empty the cache unless
+    it is enabled and holds the data of the
+    driver the machine is running
+-------------------------------------------------*/
+
+static void region_cache_begin(running_machine *machine)
+{
+	if (!cache_rom_regions || region_cache_driver != machine->gamedrv)
+		region_cache_flush();
+	region_cache_driver = cache_rom_regions ? machine->gamedrv : NULL;
+}
+
+
+/*-------------------------------------------------
+    region_cache_find - return the entry for a
+    region or stage if it came from the same
+    files
+-------------------------------------------------*/
+
+static region_cache_entry *region_cache_find(int decrypted, const char *tag, UINT32 length, UINT32 flags, UINT32 hash)
+{
+	region_cache_entry *entry;
+
+	for (entry = region_cache_list; entry != NULL; entry = entry->next)
+		if (entry->decrypted == decrypted && strcmp(entry->tag, tag) == 0)
+		{
+			LOG(("Region cache %s: %s\n", tag, (entry->length == length && entry->flags == flags && entry->hash == hash) ? "hit" : "stale"));
+			return (entry->length == length && entry->flags == flags && entry->hash == hash) ? entry : NULL;
+		}
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    region_cache_store - keep a copy of a region
+    or stage output, replacing any older one, as
+    long as the cache stays under its size cap
+-------------------------------------------------*/
+
+static void region_cache_store(int decrypted, const char *tag, UINT32 length, UINT32 flags, UINT32 hash, const void *data)
+{
+	region_cache_entry **entryptr;
+	region_cache_entry *entry;
+	UINT32 actual;
+
+	/* unlink any older copy */
+	for (entryptr = &region_cache_list; *entryptr != NULL; entryptr = &(*entryptr)->next)
+		if ((*entryptr)->decrypted == decrypted && strcmp((*entryptr)->tag, tag) == 0)
+		{
+			entry = *entryptr;
+			*entryptr = entry->next;
+			region_cache_size -= entry->length;
+			osd_close(entry->file);
+			osd_free(entry);
+			break;
+		}
+
+	/* stay within the size cap */
+	if (length > REGION_CACHE_MAX_SIZE - region_cache_size)
+	{
+		LOG(("Region cache %s: %u bytes over the cap, not kept\n", tag, length));
+		return;
+	}
+
+	/* the entries outlive every machine, so they stay out of the tracked pools */
+	entry = (region_cache_entry *)osd_malloc(sizeof(*entry) + strlen(tag));
+	if (entry == NULL)
+		return;
+	if (osd_open_anonymous(&entry->file) != FILERR_NONE)
+	{
+		osd_free(entry);
+		return;
+	}
+	if (osd_write(entry->file, data, 0, length, &actual) != FILERR_NONE || actual != length)
+	{
+		osd_close(entry->file);
+		osd_free(entry);
+		return;
+	}
+
+	entry->decrypted = decrypted;
+	entry->length = length;
+	entry->flags = flags;
+	entry->hash = hash;
+	strcpy(entry->tag, tag);
+	entry->next = region_cache_list;
+	region_cache_list = entry;
+	region_cache_size += length;
+}
+
+
+/*-------------------------------------------------
+    region_cache_flush - release everything in
+    the cache; regions mapped from it stay valid
+-------------------------------------------------*/
+
+static void region_cache_flush(void)
+{
+	while (region_cache_list != NULL)
+	{
+		region_cache_entry *entry = region_cache_list;
+
+		region_cache_list = entry->next;
+		osd_close(entry->file);
+		osd_free(entry);
+	}
+	region_cache_size = 0;
+	region_cache_driver = NULL;
+}
+
+
+/* empties the cache when the core is unloaded */
+static class region_cache_reaper
+{
+public:
+	~region_cache_reaper() { region_cache_flush(); }
+} region_cache_reaper_instance;
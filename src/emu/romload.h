@@ -279,6 +279,16 @@ int rom_load_warnings(running_machine *machine);
 
 
 
+/* ----- decrypted data cache ----- */
+
+/* fill a buffer with the output a decryption stage saved on an earlier boot of the same set; returns TRUE on a hit */
+int rom_cache_load(running_machine *machine, const char *stage, void *buffer, UINT32 length);
+
+/* save the output of a decryption stage for later boots of the same set */
+void rom_cache_save(running_machine *machine, const char *stage, const void *buffer, UINT32 length);
+
+
+
 /* ----- ROM iteration ----- */
 
 /* return pointer to first ROM source */
@@ -17,6 +17,12 @@
 #include "profiler.h"
 #include "sound/wavwrite.h"
 
+#if (defined(__SSE2__) && defined(PTR64))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 
 /***************************************************************************
@@ -33,6 +39,16 @@
 
 #define MAX_MIXER_CHANNELS		100
 
+/* highest rate the native sample rate mode hands to the OSD; chips that run
+   internally at MHz rates (AY8910, MSM5205) are resampled down to it */
+#define NATIVE_SAMPLE_RATE_MAX	96000
+
+/* register logs (-soundlog); the layout is described above sound_log_start */
+#define SOUND_LOG_MAGIC			"MSNDLOG1"
+#define SOUND_LOG_MAX_DEVICES	16
+#define SOUND_LOG_END			0xffff		/* device number of the closing entry */
+#define SOUND_LOG_BUFFER_SIZE	4096
+
 
 
 /***************************************************************************
@@ -56,10 +72,25 @@ struct _sound_private
 	int		nosound_mode;
 
 	wav_file	*wavfile;
+
+	core_file	*logfile;						/* register log, if recording */
+	int		lognumdevices;						/* number of chips in the log */
+	device_t	*logdevice[SOUND_LOG_MAX_DEVICES];	/* the chips, in log order */
+	UINT32		logbufferpos;						/* bytes waiting in logbuffer */
+	UINT8		logbuffer[SOUND_LOG_BUFFER_SIZE];	/* log data not yet written */
 };
 
 
 
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+/* set by the OSD layer to run the speakers at the sound chips' own rate */
+extern bool native_sample_rate;
+
+
+
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
@@ -72,6 +103,11 @@ static void sound_load(running_machine *machine, int config_type, xml_data_node
 static void sound_save(running_machine *machine, int config_type, xml_data_node *parentnode);
 static TIMER_CALLBACK( sound_update );
 static void route_sound(running_machine *machine);
+static void use_native_sample_rate(running_machine *machine);
+static void clamp_interleave(INT16 *dest, const INT32 *left, const INT32 *right, int samples);
+static void sound_log_start(running_machine *machine, const char *filename);
+static void sound_log_stop(running_machine *machine);
+static void sound_log_flush(sound_private *global);
 
 
 
@@ -122,6 +158,8 @@ void sound_init(running_machine *machine)
 	global->nosound_mode = !options_get_bool(machine->options(), OPTION_SOUND);
 	if (global->nosound_mode)
 		machine->sample_rate = 11025;
+	else if (native_sample_rate)
+		use_native_sample_rate(machine);
 
 	/* count the speakers */
 	VPRINTF(("total speakers = %d\n", speaker_output_count(machine->config)));
@@ -144,6 +182,11 @@ void sound_init(running_machine *machine)
 	if (filename[0] != 0)
 		global->wavfile = wav_open(filename, machine->sample_rate, 2);
 
+	/* and the register log */
+	filename = options_get_string(machine->options(), OPTION_SOUNDLOG);
+	if (filename[0] != 0)
+		sound_log_start(machine, filename);
+
 	/* enable sound by default */
 	global->enabled = TRUE;
 	global->muted = FALSE;
@@ -158,6 +201,58 @@ void sound_init(running_machine *machine)
 }
 
 
+/*-------------------------------------------------
+    use_native_sample_rate - switch the speakers
+    to the fastest rate among the chip outputs
+    routed to them (up to NATIVE_SAMPLE_RATE_MAX),
+    leaving the resampling to the OSD layer
+-------------------------------------------------*/
+
+static void use_native_sample_rate(running_machine *machine)
+{
+	device_sound_interface *sound = NULL;
+	int rate = 0;
+
+	/* find the fastest stream that feeds a speaker directly */
+	for (bool gotone = machine->m_devicelist.first(sound); gotone; gotone = sound->next(sound))
+	{
+		int numoutputs = stream_get_device_outputs(*sound);
+
+		for (const device_config_sound_interface::sound_route *route = sound->sound_config().m_route_list; route != NULL; route = route->m_next)
+		{
+			device_t *target_device = machine->device(route->m_target);
+			if (target_device == NULL || target_device->type() != SPEAKER)
+				continue;
+
+			for (int outputnum = 0; outputnum < numoutputs; outputnum++)
+			{
+				sound_stream *stream;
+				int streamoutput;
+
+				if ((route->m_output == outputnum || route->m_output == ALL_OUTPUTS) &&
+					stream_device_output_to_stream_output(*sound, outputnum, &stream, &streamoutput))
+					rate = MAX(rate, stream_get_sample_rate(stream));
+			}
+		}
+	}
+
+	/* nothing routed keeps the configured rate */
+	rate = MIN(rate, NATIVE_SAMPLE_RATE_MAX);
+	if (rate == 0 || rate == machine->sample_rate)
+		return;
+
+	/* retune the speaker mixers and apply it before anything is generated */
+	machine->sample_rate = rate;
+	for (speaker_device *speaker = speaker_first(*machine); speaker != NULL; speaker = speaker_next(speaker))
+	{
+		sound_stream *stream = stream_find_by_device(speaker, 0);
+		if (stream != NULL)
+			stream_set_sample_rate(stream, rate);
+	}
+	streams_update(machine);
+}
+
+
 /*-------------------------------------------------
     sound_exit - clean up after ourselves
 -------------------------------------------------*/
@@ -171,6 +266,10 @@ static void sound_exit(running_machine &machine)
 		wav_close(global->wavfile);
 	global->wavfile = NULL;
 
+	/* close the register log */
+	if (global->logfile != NULL)
+		sound_log_stop(&machine);
+
 	/* reset variables */
 	global->totalsnd = 0;
 }
@@ -409,32 +508,41 @@ static TIMER_CALLBACK( sound_update )
 	/* now downmix the final result */
 	finalmix_step = video_get_speed_factor();
 
-	int sample;
-	for (sample = global->finalmix_leftover; sample < samples_this_update * 100; sample += finalmix_step)
+	/* at normal speed every mixed sample goes out once, so clamp and interleave in one pass */
+	if (finalmix_step == 100 && global->finalmix_leftover == 0)
+	{
+		clamp_interleave(finalmix, leftmix, rightmix, samples_this_update);
+		finalmix_offset = samples_this_update * 2;
+	}
+	else
 	{
-		int sampindex = sample / 100;
+		int sample;
+		for (sample = global->finalmix_leftover; sample < samples_this_update * 100; sample += finalmix_step)
+		{
+			int sampindex = sample / 100;
 
-		/* clamp the left side */
-		INT32 samp = leftmix[sampindex];
+			/* clamp the left side */
+			INT32 samp = leftmix[sampindex];
 
-		if (samp < -32768)
-			samp = -32768;
-		else if (samp > 32767)
-			samp = 32767;
+			if (samp < -32768)
+				samp = -32768;
+			else if (samp > 32767)
+				samp = 32767;
 
-		finalmix[finalmix_offset++] = samp;
+			finalmix[finalmix_offset++] = samp;
 
-		/* clamp the right side */
-		samp = rightmix[sampindex];
+			/* clamp the right side */
+			samp = rightmix[sampindex];
 
-		if (samp < -32768)
-			samp = -32768;
-		else if (samp > 32767)
-			samp = 32767;
+			if (samp < -32768)
+				samp = -32768;
+			else if (samp > 32767)
+				samp = 32767;
 
-		finalmix[finalmix_offset++] = samp;
+			finalmix[finalmix_offset++] = samp;
+		}
+		global->finalmix_leftover = sample - samples_this_update * 100;
 	}
-	global->finalmix_leftover = sample - samples_this_update * 100;
 
 	/* play the result */
 	if (finalmix_offset > 0)
@@ -444,11 +552,258 @@ static TIMER_CALLBACK( sound_update )
 			wav_add_data_16(global->wavfile, finalmix, finalmix_offset);
 	}
 
+	/* keep the register log on disk current */
+	if (global->logfile != NULL)
+		sound_log_flush(global);
+
 	/* update the streamer */
 	streams_update(machine);
 }
 
 
+/*-------------------------------------------------
+    clamp_interleave - clamp the left and right
+    mixes to 16 bits and interleave them
+-------------------------------------------------*/
+
+static void clamp_interleave(INT16 *dest, const INT32 *left, const INT32 *right, int samples)
+{
+	int sample = 0;
+
+#if (defined(__SSE2__) && defined(PTR64))
+	for ( ; sample + 8 <= samples; sample += 8)
+	{
+		__m128i l = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)&left[sample]), _mm_loadu_si128((const __m128i *)&left[sample + 4]));
+		__m128i r = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)&right[sample]), _mm_loadu_si128((const __m128i *)&right[sample + 4]));
+		_mm_storeu_si128((__m128i *)&dest[sample * 2], _mm_unpacklo_epi16(l, r));
+		_mm_storeu_si128((__m128i *)&dest[sample * 2 + 8], _mm_unpackhi_epi16(l, r));
+	}
+#elif defined(__ARM_NEON__)
+	for ( ; sample + 4 <= samples; sample += 4)
+	{
+		int16x4x2_t lr;
+		lr.val[0] = vqmovn_s32(vld1q_s32(&left[sample]));
+		lr.val[1] = vqmovn_s32(vld1q_s32(&right[sample]));
+		vst2_s16(&dest[sample * 2], lr);
+	}
+#endif
+
+	for ( ; sample < samples; sample++)
+	{
+		INT32 samp = left[sample];
+		dest[sample * 2] = (samp < -32768) ? -32768 : (samp > 32767) ? 32767 : samp;
+		samp = right[sample];
+		dest[sample * 2 + 1] = (samp < -32768) ? -32768 : (samp > 32767) ? 32767 : samp;
+	}
+}
+
+
+
+/***************************************************************************
+    REGISTER LOGS
+***************************************************************************/
+
+/*
+    A register log (-soundlog) records what the sound chips were told, so
+    that a headless replay can drive the same chips without the CPUs that
+    fed them. All values are little-endian; strings are a length byte
+    followed by that many characters.
+
+    header:  "MSNDLOG1", UINT32 number of chips, then for each chip:
+             name string (device name), tag string, UINT32 clock,
+             UINT32 number of regions, then for each region the chip
+             reads (its own and any named "tag.xxx"): name string,
+             UINT32 flags, UINT32 length, and the region contents
+
+    entries: UINT32 seconds, UINT64 attoseconds, UINT16 port, UINT16 chip,
+             UINT32 data; chip SOUND_LOG_END closes the log at the time
+             the machine stopped
+
+    The port is the offset given to the chip's write handler; each chip
+    header lists any extra ports it logs for writes that bypass it.
+*/
+
+/*-------------------------------------------------
+    sound_log_flush - write out the buffered
+    part of the log
+-------------------------------------------------*/
+
+static void sound_log_flush(sound_private *global)
+{
+	if (global->logbufferpos != 0)
+		core_fwrite(global->logfile, global->logbuffer, global->logbufferpos);
+	global->logbufferpos = 0;
+}
+
+
+/*-------------------------------------------------
+    sound_log_put - append raw data to the log
+-------------------------------------------------*/
+
+static void sound_log_put(sound_private *global, const void *data, UINT32 length)
+{
+	if (global->logbufferpos + length > SOUND_LOG_BUFFER_SIZE)
+	{
+		sound_log_flush(global);
+
+		/* region contents go straight to the file */
+		if (length > SOUND_LOG_BUFFER_SIZE)
+		{
+			core_fwrite(global->logfile, data, length);
+			return;
+		}
+	}
+	memcpy(&global->logbuffer[global->logbufferpos], data, length);
+	global->logbufferpos += length;
+}
+
+
+/*-------------------------------------------------
+    sound_log_put32/sound_log_put_string -
+    append a value or a string to the log
+-------------------------------------------------*/
+
+static void sound_log_put32(sound_private *global, UINT32 value)
+{
+	UINT8 bytes[4];
+
+	bytes[0] = value;
+	bytes[1] = value >> 8;
+	bytes[2] = value >> 16;
+	bytes[3] = value >> 24;
+	sound_log_put(global, bytes, sizeof(bytes));
+}
+
+static void sound_log_put_string(sound_private *global, const char *string)
+{
+	UINT8 length = MIN(strlen(string), 255);
+
+	sound_log_put(global, &length, 1);
+	sound_log_put(global, string, length);
+}
+
+
+/*-------------------------------------------------
+    sound_log_put_entry - append one timed entry
+-------------------------------------------------*/
+
+static void sound_log_put_entry(sound_private *global, attotime time, int devnum, int port, UINT32 data)
+{
+	sound_log_put32(global, time.seconds);
+	sound_log_put32(global, (UINT32)time.attoseconds);
+	sound_log_put32(global, (UINT32)(time.attoseconds >> 32));
+	sound_log_put32(global, (devnum << 16) | (port & 0xffff));
+	sound_log_put32(global, data);
+}
+
+
+/*-------------------------------------------------
+    region_is_for_device - return TRUE if a
+    region is read by a sound chip
+-------------------------------------------------*/
+
+static int region_is_for_device(const region_info *region, device_t *device)
+{
+	int taglen = strlen(device->tag());
+
+	return (strncmp(region->name(), device->tag(), taglen) == 0 && (region->name()[taglen] == 0 || region->name()[taglen] == '.'));
+}
+
+
+/*-------------------------------------------------
+    sound_log_start - open the register log and
+    write the chips and their regions to it
+-------------------------------------------------*/
+
+static void sound_log_start(running_machine *machine, const char *filename)
+{
+	sound_private *global = machine->sound_data;
+	device_sound_interface *sound = NULL;
+	file_error filerr;
+	int devnum;
+
+	filerr = core_fopen(filename, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE, &global->logfile);
+	if (filerr != FILERR_NONE)
+	{
+		mame_printf_warning("Unable to open sound log %s\n", filename);
+		global->logfile = NULL;
+		return;
+	}
+
+	/* every sound chip gets a number, whether or not it logs its writes */
+	for (bool gotone = machine->m_devicelist.first(sound); gotone && global->lognumdevices < SOUND_LOG_MAX_DEVICES; gotone = sound->next(sound))
+		global->logdevice[global->lognumdevices++] = &sound->device();
+
+	sound_log_put(global, SOUND_LOG_MAGIC, 8);
+	sound_log_put32(global, global->lognumdevices);
+	for (devnum = 0; devnum < global->lognumdevices; devnum++)
+	{
+		device_t *device = global->logdevice[devnum];
+		const region_info *region;
+		int regions = 0;
+
+		sound_log_put_string(global, device->name());
+		sound_log_put_string(global, device->tag());
+		sound_log_put32(global, device->clock());
+
+		for (region = machine->m_regionlist.first(); region != NULL; region = region->next())
+			if (region_is_for_device(region, device))
+				regions++;
+		sound_log_put32(global, regions);
+
+		for (region = machine->m_regionlist.first(); region != NULL; region = region->next())
+			if (region_is_for_device(region, device))
+			{
+				sound_log_put_string(global, region->name());
+				sound_log_put32(global, region->flags());
+				sound_log_put32(global, region->bytes());
+				sound_log_put(global, region->base(), region->bytes());
+			}
+	}
+	sound_log_flush(global);
+}
+
+
+/*-------------------------------------------------
+    sound_log_stop - close the register log
+-------------------------------------------------*/
+
+static void sound_log_stop(running_machine *machine)
+{
+	sound_private *global = machine->sound_data;
+
+	sound_log_put_entry(global, timer_get_time(machine), SOUND_LOG_END, 0, 0);
+	sound_log_flush(global);
+	core_fclose(global->logfile);
+	global->logfile = NULL;
+}
+
+
+/*-------------------------------------------------
+    sound_log_write - log a write to a sound
+    chip, if a register log is being recorded;
+    called by the chips themselves
+-------------------------------------------------*/
+
+void sound_log_write(device_t *device, int port, UINT32 data)
+{
+	sound_private *global = device->machine->sound_data;
+	int devnum;
+
+	/* writes before the sound system starts are lost; the chips log the
+       state those set up when they are reset */
+	if (global == NULL || global->logfile == NULL)
+		return;
+
+	for (devnum = 0; devnum < global->lognumdevices; devnum++)
+		if (global->logdevice[devnum] == device)
+		{
+			sound_log_put_entry(global, timer_get_time(device->machine), devnum, port, data);
+			break;
+		}
+}
+
+
 
 //**************************************************************************
 //  SPEAKER DEVICE CONFIGURATION
@@ -664,13 +1019,16 @@ void speaker_device::mix(INT32 *leftmix, INT32 *rightmix, int &samples_this_upda
 	const stream_sample_t *stream_buf = stream_get_output_since_last_update(m_mixer_stream, 0, &numsamples);
 
 	// set or assert that all streams have the same count
-	if (samples_this_update == 0)
+	bool first = (samples_this_update == 0);
+	if (first)
 	{
 		samples_this_update = numsamples;
 
-		/* reset the mixing streams */
-		memset(leftmix, 0, samples_this_update * sizeof(*leftmix));
-		memset(rightmix, 0, samples_this_update * sizeof(*rightmix));
+		/* reset the mixing streams; the first speaker that plays writes over them instead */
+		if (suppress || m_config.m_x > 0)
+			memset(leftmix, 0, samples_this_update * sizeof(*leftmix));
+		if (suppress || m_config.m_x < 0)
+			memset(rightmix, 0, samples_this_update * sizeof(*rightmix));
 	}
 	assert(samples_this_update == numsamples);
 
@@ -687,8 +1045,17 @@ void speaker_device::mix(INT32 *leftmix, INT32 *rightmix, int &samples_this_upda
 		m_total_samples++;
 	}
 #endif
+	// the first speaker copies rather than adds
+	if (!suppress && first)
+	{
+		if (m_config.m_x <= 0)
+			memcpy(leftmix, stream_buf, samples_this_update * sizeof(*leftmix));
+		if (m_config.m_x >= 0)
+			memcpy(rightmix, stream_buf, samples_this_update * sizeof(*rightmix));
+	}
+
 	// mix if sound is enabled
-	if (!suppress)
+	else if (!suppress)
 	{
 		// if the speaker is centered, send to both left and right
 		if (m_config.m_x == 0)
@@ -174,6 +174,9 @@ const char *sound_get_user_gain_name(running_machine *machine, int index);
 /* driver gain controls on chip outputs */
 void sound_set_output_gain(device_t *device, int output, float gain);
 
+/* register logs; chips report each write they take */
+void sound_log_write(device_t *device, int port, UINT32 data);
+
 
 
 //**************************************************************************
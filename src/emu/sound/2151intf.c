@@ -39,6 +39,13 @@ static STREAM_UPDATE( ym2151_update )
 }
 
 
+static STREAM_JOURNAL( ym2151_journal_w )
+{
+	ym2151_state *info = (ym2151_state *)param;
+	ym2151_write_reg(info->chip, offset, data);
+}
+
+
 static STATE_POSTLOAD( ym2151intf_postload )
 {
 	ym2151_state *info = (ym2151_state *)param;
@@ -78,6 +85,7 @@ static DEVICE_STOP( ym2151 )
 static DEVICE_RESET( ym2151 )
 {
 	ym2151_state *info = get_safe_token(device);
+	stream_update(info->stream);
 	ym2151_reset_chip(info->chip);
 }
 
@@ -86,11 +94,9 @@ READ8_DEVICE_HANDLER( ym2151_r )
 {
 	ym2151_state *token = get_safe_token(device);
 
+	/* the status only holds the timer flags, which don't depend on the stream */
 	if (offset & 1)
-	{
-		stream_update(token->stream);
 		return ym2151_read_status(token->chip);
-	}
 	else
 		return 0xff;	/* confirmed on a real YM2151 */
 }
@@ -99,10 +105,18 @@ WRITE8_DEVICE_HANDLER( ym2151_w )
 {
 	ym2151_state *token = get_safe_token(device);
 
+	sound_log_write(device, offset & 1, data);
+
 	if (offset & 1)
 	{
-		stream_update(token->stream);
-		ym2151_write_reg(token->chip, token->lastreg, data);
+		/* the timers and the CT port act outside the chip; everything else can wait in the journal */
+		if ((token->lastreg >= 0x10 && token->lastreg <= 0x14) || token->lastreg == 0x1b)
+		{
+			stream_update(token->stream);
+			ym2151_write_reg(token->chip, token->lastreg, data);
+		}
+		else
+			stream_journal_write(token->stream, ym2151_journal_w, token->lastreg, data);
 	}
 	else
 		token->lastreg = data;
@@ -172,6 +172,7 @@ READ8_DEVICE_HANDLER( ym2203_r )
 WRITE8_DEVICE_HANDLER( ym2203_w )
 {
 	ym2203_state *info = get_safe_token(device);
+	sound_log_write(device, offset & 1, data);
 	ym2203_write(info->chip, offset & 1, data);
 }
 
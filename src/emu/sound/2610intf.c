@@ -26,6 +26,8 @@ struct _ym2610_state
 	void *			psg;
 	const ym2610_interface *intf;
 	running_device *device;
+	UINT8			address;	/* last address written */
+	UINT8			port;		/* port the address was written to */
 };
 
 
@@ -114,16 +116,62 @@ void ym2610_update_request(void *param)
 }
 
 
+/* writes that can start an idle chip (FM key on, CSM/3 slot mode, ADPCM-A key on,
+   delta-T start) or change how its free-running clocks advance (LFO, prescaler) */
+INLINE int ym2610_wakes(int port, int addr, UINT8 data)
+{
+	if (port == 1)
+		return addr == 0x00 && !(data & 0x80) && (data & 0x3f);
+	return (addr == 0x28 && (data & 0xf0)) || (addr == 0x27 && (data & 0xc0)) || (addr == 0x10 && (data & 0x80)) ||
+		addr == 0x22 || (addr >= 0x2d && addr <= 0x2f);
+}
+
+/* resume generating, catching the chip up on the samples skipped while idle */
+static void ym2610_wake(ym2610_state *info)
+{
+	ym2610_skip_idle(info->chip, info->device->type() == SOUND_YM2610B, stream_wake(info->stream));
+}
+
+
+/* apply a journaled write; offset is (port << 8) | address */
+static STREAM_JOURNAL( ym2610_journal_w )
+{
+	ym2610_state *info = (ym2610_state *)param;
+	int port = (offset >> 8) * 2;
+
+	if (ym2610_wakes(offset >> 8, offset & 0xff, data))
+		ym2610_wake(info);
+	ym2610_write(info->chip, port, offset & 0xff);
+	ym2610_write(info->chip, port + 1, data);
+
+	/* put back the address the CPU last selected */
+	ym2610_write(info->chip, info->port * 2, info->address);
+}
+
+/* writes that only change the generated sound; timers, prescaler and SSG go straight through */
+INLINE int ym2610_journaled(ym2610_state *info)
+{
+	int addr = info->address;
+
+	if (info->port == 1)
+		return TRUE;
+	return addr >= 0x30 || (addr >= 0x10 && addr <= 0x1c) || addr == 0x22 || addr == 0x28;
+}
+
 static STREAM_UPDATE( ym2610_stream_update )
 {
 	ym2610_state *info = (ym2610_state *)param;
 	ym2610_update_one(info->chip, outputs, samples);
+	if (ym2610_is_idle(info->chip, FALSE))
+		stream_set_idle(info->stream);
 }
 
 static STREAM_UPDATE( ym2610b_stream_update )
 {
 	ym2610_state *info = (ym2610_state *)param;
 	ym2610b_update_one(info->chip, outputs, samples);
+	if (ym2610_is_idle(info->chip, TRUE))
+		stream_set_idle(info->stream);
 }
 
 
@@ -180,6 +228,8 @@ static DEVICE_START( ym2610 )
 		           timer_handler,IRQHandler,&psgintf);
 	assert_always(info->chip != NULL, "Error creating YM2610 chip");
 
+	state_save_register_device_item(device, 0, info->address);
+	state_save_register_device_item(device, 0, info->port);
 	state_save_register_postload(device->machine, ym2610_intf_postload, info);
 }
 
@@ -193,6 +243,11 @@ static DEVICE_STOP( ym2610 )
 static DEVICE_RESET( ym2610 )
 {
 	ym2610_state *info = get_safe_token(device);
+	stream_update(info->stream);
+
+	/* nothing to catch up on; the reset starts the chip over (and the first
+       one comes before the envelope clock is set up) */
+	stream_wake(info->stream);
 	ym2610_reset_chip(info->chip);
 }
 
@@ -200,13 +255,43 @@ static DEVICE_RESET( ym2610 )
 READ8_DEVICE_HANDLER( ym2610_r )
 {
 	ym2610_state *info = get_safe_token(device);
+
+	/* the ADPCM end flags depend on the queued writes and the generated samples */
+	if ((offset & 3) == 2)
+		stream_update(info->stream);
 	return ym2610_read(info->chip, offset & 3);
 }
 
 WRITE8_DEVICE_HANDLER( ym2610_w )
 {
 	ym2610_state *info = get_safe_token(device);
-	ym2610_write(info->chip, offset & 3, data);
+
+	sound_log_write(device, offset & 3, data);
+
+	switch (offset & 3)
+	{
+		case 0:
+		case 2:
+			info->address = data;
+			info->port = (offset >> 1) & 1;
+			ym2610_write(info->chip, offset & 3, data);
+			break;
+
+		case 1:
+		case 3:
+			if (info->port == ((offset >> 1) & 1) && ym2610_journaled(info))
+				stream_journal_write(info->stream, ym2610_journal_w, (info->port << 8) | info->address, data);
+			else if (info->port == 0 && info->address < 0x10)
+				ym2610_write(info->chip, offset & 3, data);		/* SSG has its own stream */
+			else
+			{
+				stream_update(info->stream);
+				if (info->port != ((offset >> 1) & 1) || ym2610_wakes(info->port, info->address, data))
+					ym2610_wake(info);
+				ym2610_write(info->chip, offset & 3, data);
+			}
+			break;
+	}
 }
 
 
@@ -1045,12 +1045,16 @@ READ8_DEVICE_HANDLER( ay8910_r )
 
 WRITE8_DEVICE_HANDLER( ay8910_data_address_w )
 {
+	/* logged as ay8910_address_data_w ports */
+	sound_log_write(device, ~offset & 1, data);
+
 	/* note that directly connecting BC1 to A0 puts data on 0 and address on 1 */
 	ay8910_write_ym(get_safe_token(device), ~offset & 1, data);
 }
 
 WRITE8_DEVICE_HANDLER( ay8910_address_data_w )
 {
+	sound_log_write(device, offset & 1, data);
 	ay8910_write_ym(get_safe_token(device), offset & 1, data);
 }
 
@@ -114,6 +114,12 @@
 #include "emu.h"
 #include "fm.h"
 
+#if (defined(__SSE2__) && defined(PTR64))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 /* include external DELTA-T unit (when needed) */
 #if (BUILD_YM2608||BUILD_YM2610||BUILD_YM2610B)
@@ -674,6 +680,22 @@ static INT32	out_delta[4];	/* channel output NONE,LEFT,RIGHT or CENTER for YM260
 static UINT32	LFO_AM;			/* runtime LFO calculations helper */
 static INT32	LFO_PM;			/* runtime LFO calculations helper */
 
+/* OPN channels are rendered one channel at a time over blocks of FM_BLOCK
+   samples; the LFO and envelope clock are sampled once per block first */
+#define FM_BLOCK	128
+
+int fm_block_render = 1;
+
+static UINT32	blk_lfo_am[FM_BLOCK];	/* LFO_AM for each sample of the block */
+static INT32	blk_lfo_pm[FM_BLOCK];	/* LFO_PM for each sample of the block */
+static UINT32	blk_eg_cnt[FM_BLOCK];	/* eg_cnt before the envelope ticks of each sample */
+static UINT32	blk_eg_ticks[FM_BLOCK];	/* number of envelope ticks of each sample */
+static INT32	blk_out_fm[6][FM_BLOCK];	/* rendered output of each channel */
+#if (BUILD_YM2608||BUILD_YM2610||BUILD_YM2610B)
+static INT32	blk_out_l[FM_BLOCK];	/* ADPCM output, left */
+static INT32	blk_out_r[FM_BLOCK];	/* ADPCM output, right */
+#endif
+
 /* log output level */
 #define LOG_ERR  3      /* ERROR       */
 #define LOG_WAR  2      /* WARNING     */
@@ -1343,6 +1365,8 @@ INLINE void update_phase_lfo_channel(FM_OPN *OPN, FM_CH *CH)
 	}
 }
 
+INLINE void chan_update_phase(FM_OPN *OPN, FM_CH *CH, int chnum);
+
 INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH, int chnum)
 {
 	unsigned int eg_out;
@@ -1396,6 +1420,11 @@ INLINE void chan_calc(FM_OPN *OPN, FM_CH *CH, int chnum)
 	CH->mem_value = mem;
 
 	/* update phase counters AFTER output calculations */
+	chan_update_phase(OPN, CH, chnum);
+}
+
+INLINE void chan_update_phase(FM_OPN *OPN, FM_CH *CH, int chnum)
+{
 	if(CH->pms)
 	{
 		/* add support for 3 slot mode */
@@ -1470,6 +1499,182 @@ static void refresh_fc_eg_chan(FM_OPN *OPN, FM_CH *CH )
 	}
 }
 
+/* sample the LFO and the envelope clock for a block of samples */
+static void opn_prepare_block(FM_OPN *OPN, int length, int has_lfo)
+{
+	int i;
+
+	for (i = 0; i < length; i++)
+	{
+		UINT32 ticks = 0;
+
+		if (has_lfo)
+			advance_lfo(OPN);
+		blk_lfo_am[i] = LFO_AM;
+		blk_lfo_pm[i] = LFO_PM;
+
+		blk_eg_cnt[i] = OPN->eg_cnt;
+		OPN->eg_timer += OPN->eg_timer_add;
+		while (OPN->eg_timer >= OPN->eg_timer_overflow)
+		{
+			OPN->eg_timer -= OPN->eg_timer_overflow;
+			OPN->eg_cnt++;
+			ticks++;
+		}
+		blk_eg_ticks[i] = ticks;
+	}
+}
+
+/* a channel whose operators are all off, with nothing left in its feedback or
+   delay memory, outputs silence until the next key on; only its phase moves */
+INLINE int chan_is_idle(FM_CH *CH)
+{
+	int s;
+
+	for (s = 0; s < 4; s++)
+		if (CH->SLOT[s].state != EG_OFF || CH->SLOT[s].volume < ENV_QUIET || CH->SLOT[s].vol_out < ENV_QUIET)
+			return 0;
+
+	return !CH->op1_out[0] && !CH->op1_out[1] && !CH->mem_value;
+}
+
+/* render one channel over the block prepared by opn_prepare_block */
+static void opn_render_channel(FM_OPN *OPN, FM_CH *CH, int chnum, INT32 *dest, int length)
+{
+	UINT32 eg_cnt = OPN->eg_cnt;
+	int i;
+
+	if (chan_is_idle(CH))
+	{
+		UINT32 ticks = 0;
+		int s;
+
+		memset(dest, 0, length * sizeof(*dest));
+
+		/* the envelope only refreshes vol_out while off */
+		for (i = 0; i < length; i++)
+			ticks += blk_eg_ticks[i];
+		if (ticks)
+			for (s = 0; s < 4; s++)
+				CH->SLOT[s].vol_out = CH->SLOT[s].volume + CH->SLOT[s].tl;
+
+		if (CH->pms)
+		{
+			for (i = 0; i < length; i++)
+			{
+				LFO_PM = blk_lfo_pm[i];
+				chan_update_phase(OPN, CH, chnum);
+			}
+		}
+		else
+		{
+			for (s = 0; s < 4; s++)
+				CH->SLOT[s].phase += CH->SLOT[s].Incr * length;
+		}
+		return;
+	}
+
+	for (i = 0; i < length; i++)
+	{
+		UINT32 t;
+
+		for (t = 1; t <= blk_eg_ticks[i]; t++)
+		{
+			OPN->eg_cnt = blk_eg_cnt[i] + t;
+			advance_eg_channel(OPN, &CH->SLOT[SLOT1]);
+		}
+
+		LFO_AM = blk_lfo_am[i];
+		LFO_PM = blk_lfo_pm[i];
+		out_fm[chnum] = 0;
+		chan_calc(OPN, CH, chnum);
+		dest[i] = out_fm[chnum];
+	}
+
+	OPN->eg_cnt = eg_cnt;
+}
+
+/* mix rendered channels with their pan masks (all enabled if pan is NULL),
+   add the base signal and clamp to the output range */
+static void opn_mix_block(const unsigned int *pan, const int *chnum, int numchans, int shift, FMSAMPLE *bufL, FMSAMPLE *bufR, const INT32 *baseL, const INT32 *baseR, int length)
+{
+	UINT32 maskl[6], maskr[6];
+	int i = 0;
+	int c;
+
+	for (c = 0; c < numchans; c++)
+	{
+		maskl[c] = pan ? pan[chnum[c] * 2 + 0] : ~0;
+		maskr[c] = pan ? pan[chnum[c] * 2 + 1] : ~0;
+	}
+
+#if (FM_SAMPLE_BITS==16) && (defined(__SSE2__) && defined(PTR64))
+	for ( ; i + 4 <= length; i += 4)
+	{
+		__m128i lt = baseL ? _mm_loadu_si128((const __m128i *)&baseL[i]) : _mm_setzero_si128();
+		__m128i rt = baseR ? _mm_loadu_si128((const __m128i *)&baseR[i]) : _mm_setzero_si128();
+
+		for (c = 0; c < numchans; c++)
+		{
+			__m128i fm = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)&blk_out_fm[c][i]), shift);
+			lt = _mm_add_epi32(lt, _mm_and_si128(fm, _mm_set1_epi32(maskl[c])));
+			rt = _mm_add_epi32(rt, _mm_and_si128(fm, _mm_set1_epi32(maskr[c])));
+		}
+		lt = _mm_srai_epi32(lt, FINAL_SH);
+		rt = _mm_srai_epi32(rt, FINAL_SH);
+
+		/* saturate to 16 bits and sign extend back */
+		lt = _mm_packs_epi32(lt, lt);
+		rt = _mm_packs_epi32(rt, rt);
+		_mm_storeu_si128((__m128i *)&bufL[i], _mm_srai_epi32(_mm_unpacklo_epi16(lt, lt), 16));
+		if (bufR)
+			_mm_storeu_si128((__m128i *)&bufR[i], _mm_srai_epi32(_mm_unpacklo_epi16(rt, rt), 16));
+	}
+#elif (FM_SAMPLE_BITS==16) && defined(__ARM_NEON__)
+	for ( ; i + 4 <= length; i += 4)
+	{
+		int32x4_t lt = baseL ? vld1q_s32(&baseL[i]) : vdupq_n_s32(0);
+		int32x4_t rt = baseR ? vld1q_s32(&baseR[i]) : vdupq_n_s32(0);
+
+		for (c = 0; c < numchans; c++)
+		{
+			int32x4_t fm = vshlq_s32(vld1q_s32(&blk_out_fm[c][i]), vdupq_n_s32(-shift));
+			lt = vaddq_s32(lt, vandq_s32(fm, vdupq_n_s32(maskl[c])));
+			rt = vaddq_s32(rt, vandq_s32(fm, vdupq_n_s32(maskr[c])));
+		}
+		lt = vshlq_s32(lt, vdupq_n_s32(-FINAL_SH));
+		rt = vshlq_s32(rt, vdupq_n_s32(-FINAL_SH));
+
+		/* saturate to 16 bits and sign extend back */
+		vst1q_s32(&bufL[i], vmovl_s16(vqmovn_s32(lt)));
+		if (bufR)
+			vst1q_s32(&bufR[i], vmovl_s16(vqmovn_s32(rt)));
+	}
+#endif
+
+	for ( ; i < length; i++)
+	{
+		int lt = baseL ? baseL[i] : 0;
+		int rt = baseR ? baseR[i] : 0;
+
+		for (c = 0; c < numchans; c++)
+		{
+			lt += ((blk_out_fm[c][i] >> shift) & maskl[c]);
+			rt += ((blk_out_fm[c][i] >> shift) & maskr[c]);
+		}
+
+		lt >>= FINAL_SH;
+		rt >>= FINAL_SH;
+
+		Limit( lt, MAXOUT, MINOUT );
+		Limit( rt, MAXOUT, MINOUT );
+
+		bufL[i] = lt;
+		if (bufR)
+			bufR[i] = rt;
+	}
+}
+
 /* initialize time tables */
 static void init_timetables( FM_ST *ST , const UINT8 *dttable )
 {
@@ -2121,51 +2326,87 @@ void ym2203_update_one(void *chip, FMSAMPLE *buffer, int length)
 	LFO_AM = 0;
 	LFO_PM = 0;
 
-	/* buffering */
-	for (i=0; i < length ; i++)
+	if (fm_block_render)
 	{
-		/* clear outputs */
-		out_fm[0] = 0;
-		out_fm[1] = 0;
-		out_fm[2] = 0;
-
-		/* advance envelope generator */
-		OPN->eg_timer += OPN->eg_timer_add;
-		while (OPN->eg_timer >= OPN->eg_timer_overflow)
+		/* buffering, one block of channel batches at a time */
+		for (i=0; i < length ; i += FM_BLOCK)
 		{
-			OPN->eg_timer -= OPN->eg_timer_overflow;
-			OPN->eg_cnt++;
+			static const int chnum[3] = { 0, 1, 2 };
+			int count = MIN(length - i, FM_BLOCK);
+			int j;
 
-			advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
-		}
+			opn_prepare_block(OPN, count, 0);
 
-		/* calculate FM */
-		chan_calc(OPN, cch[0], 0 );
-		chan_calc(OPN, cch[1], 1 );
-		chan_calc(OPN, cch[2], 2 );
+			/* calculate FM */
+			for (j = 0; j < 3; j++)
+				opn_render_channel(OPN, cch[j], chnum[j], blk_out_fm[j], count);
+
+			/* buffering */
+			opn_mix_block(NULL, chnum, 3, 0, &buf[i], NULL, NULL, NULL, count);
+
+			#ifdef SAVE_SAMPLE
+			for (j = 0; j < count; j++)
+			{
+				int lt = buf[i + j];
+				SAVE_ALL_CHANNELS
+			}
+			#endif
 
+#if FM_INTERNAL_TIMER
+			/* timer A control; a CSM key on lands at the next block */
+			for (j = 0; j < count; j++)
+				INTERNAL_TIMER_A( &F2203->OPN.ST , cch[2] )
+#endif
+		}
+	}
+	else
+	{
 		/* buffering */
+		for (i=0; i < length ; i++)
 		{
-			int lt;
+			/* clear outputs */
+			out_fm[0] = 0;
+			out_fm[1] = 0;
+			out_fm[2] = 0;
+
+			/* advance envelope generator */
+			OPN->eg_timer += OPN->eg_timer_add;
+			while (OPN->eg_timer >= OPN->eg_timer_overflow)
+			{
+				OPN->eg_timer -= OPN->eg_timer_overflow;
+				OPN->eg_cnt++;
 
-			lt = out_fm[0] + out_fm[1] + out_fm[2];
+				advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
+			}
 
-			lt >>= FINAL_SH;
+			/* calculate FM */
+			chan_calc(OPN, cch[0], 0 );
+			chan_calc(OPN, cch[1], 1 );
+			chan_calc(OPN, cch[2], 2 );
+
+			/* buffering */
+			{
+				int lt;
 
-			Limit( lt , MAXOUT, MINOUT );
+				lt = out_fm[0] + out_fm[1] + out_fm[2];
 
-			#ifdef SAVE_SAMPLE
-				SAVE_ALL_CHANNELS
-			#endif
+				lt >>= FINAL_SH;
 
-			/* buffering */
-			buf[i] = lt;
-		}
+				Limit( lt , MAXOUT, MINOUT );
 
-		/* timer A control */
-		INTERNAL_TIMER_A( &F2203->OPN.ST , cch[2] )
+				#ifdef SAVE_SAMPLE
+					SAVE_ALL_CHANNELS
+				#endif
+
+				/* buffering */
+				buf[i] = lt;
+			}
+
+			/* timer A control */
+			INTERNAL_TIMER_A( &F2203->OPN.ST , cch[2] )
+		}
 	}
 	INTERNAL_TIMER_B(&F2203->OPN.ST,length)
 }
@@ -3791,6 +4032,33 @@ int ym2608_timer_over(void *chip,int c)
 #if (BUILD_YM2610||BUILD_YM2610B)
 /* YM2610(OPNB) */
 
+/* run the deltaT and ADPCMA units over a block, collecting their stereo output */
+static void ym2610_render_adpcm(YM2610 *F2610, YM_DELTAT *DELTAT, INT32 *outl, INT32 *outr, int length)
+{
+	int i,j;
+
+	for (i = 0; i < length; i++)
+	{
+		/* clear output acc. */
+		out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
+		out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
+
+		/* deltaT ADPCM */
+		if( DELTAT->portstate&0x80 )
+			YM_DELTAT_ADPCM_CALC(DELTAT);
+
+		/* ADPCMA */
+		for( j = 0; j < 6; j++ )
+		{
+			if( F2610->adpcm[j].flag )
+				ADPCMA_calc_chan( F2610, &F2610->adpcm[j]);
+		}
+
+		outl[i] = out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER] + ((out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9);
+		outr[i] = out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER] + ((out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9);
+	}
+}
+
 /* Generate samples for one of the YM2610s */
 void ym2610_update_one(void *chip, FMSAMPLE **buffer, int length)
 {
@@ -3839,89 +4107,127 @@ void ym2610_update_one(void *chip, FMSAMPLE **buffer, int length)
 	refresh_fc_eg_chan( OPN, cch[2] );
 	refresh_fc_eg_chan( OPN, cch[3] );
 
-	/* buffering */
-	for(i=0; i < length ; i++)
+	if (fm_block_render)
 	{
+		/* buffering, one block of channel batches at a time */
+		for(i=0; i < length ; i += FM_BLOCK)
+		{
+			static const int chnum[4] = { 1, 2, 4, 5 };
+			int count = MIN(length - i, FM_BLOCK);
 
-		advance_lfo(OPN);
+			opn_prepare_block(OPN, count, 1);
 
-		/* clear output acc. */
-		out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
-		out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
-		/* clear outputs */
-		out_fm[1] = 0;
-		out_fm[2] = 0;
-		out_fm[4] = 0;
-		out_fm[5] = 0;
+			/* calculate FM */
+			for (j = 0; j < 4; j++)
+				opn_render_channel(OPN, cch[j], chnum[j], blk_out_fm[j], count);
 
-		/* advance envelope generator */
-		OPN->eg_timer += OPN->eg_timer_add;
-		while (OPN->eg_timer >= OPN->eg_timer_overflow)
-		{
-			OPN->eg_timer -= OPN->eg_timer_overflow;
-			OPN->eg_cnt++;
+			/* deltaT ADPCM and ADPCMA */
+			ym2610_render_adpcm(F2610, DELTAT, blk_out_l, blk_out_r, count);
 
-			advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
-		}
-
-		/* calculate FM */
-		chan_calc(OPN, cch[0], 1 );	/*remapped to 1*/
-		chan_calc(OPN, cch[1], 2 );	/*remapped to 2*/
-		chan_calc(OPN, cch[2], 4 );	/*remapped to 4*/
-		chan_calc(OPN, cch[3], 5 );	/*remapped to 5*/
+			/* buffering */
+			opn_mix_block(OPN->pan, chnum, 4, 1, &bufL[i], &bufR[i], blk_out_l, blk_out_r, count);	/* the shift right was verified on real chip */
 
-		/* deltaT ADPCM */
-		if( DELTAT->portstate&0x80 )
-			YM_DELTAT_ADPCM_CALC(DELTAT);
+			#ifdef SAVE_SAMPLE
+			for (j = 0; j < count; j++)
+			{
+				int lt = bufL[i + j], rt = bufR[i + j];
+				SAVE_ALL_CHANNELS
+			}
+			#endif
 
-		/* ADPCMA */
-		for( j = 0; j < 6; j++ )
-		{
-			if( F2610->adpcm[j].flag )
-				ADPCMA_calc_chan( F2610, &F2610->adpcm[j]);
+#if FM_INTERNAL_TIMER
+			/* timer A control; a CSM key on lands at the next block */
+			for (j = 0; j < count; j++)
+				INTERNAL_TIMER_A( &OPN->ST , cch[1] )
+#endif
 		}
-
+	}
+	else
+	{
 		/* buffering */
+		for(i=0; i < length ; i++)
 		{
-			int lt,rt;
 
-			lt =  out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER];
-			rt =  out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER];
-			lt += (out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9;
-			rt += (out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9;
+			advance_lfo(OPN);
 
+			/* clear output acc. */
+			out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
+			out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
+			/* clear outputs */
+			out_fm[1] = 0;
+			out_fm[2] = 0;
+			out_fm[4] = 0;
+			out_fm[5] = 0;
 
-			lt += ((out_fm[1]>>1) & OPN->pan[2]);	/* the shift right was verified on real chip */
-			rt += ((out_fm[1]>>1) & OPN->pan[3]);
-			lt += ((out_fm[2]>>1) & OPN->pan[4]);
-			rt += ((out_fm[2]>>1) & OPN->pan[5]);
-
-			lt += ((out_fm[4]>>1) & OPN->pan[8]);
-			rt += ((out_fm[4]>>1) & OPN->pan[9]);
-			lt += ((out_fm[5]>>1) & OPN->pan[10]);
-			rt += ((out_fm[5]>>1) & OPN->pan[11]);
+			/* advance envelope generator */
+			OPN->eg_timer += OPN->eg_timer_add;
+			while (OPN->eg_timer >= OPN->eg_timer_overflow)
+			{
+				OPN->eg_timer -= OPN->eg_timer_overflow;
+				OPN->eg_cnt++;
 
+				advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
+			}
 
-			lt >>= FINAL_SH;
-			rt >>= FINAL_SH;
+			/* calculate FM */
+			chan_calc(OPN, cch[0], 1 );	/*remapped to 1*/
+			chan_calc(OPN, cch[1], 2 );	/*remapped to 2*/
+			chan_calc(OPN, cch[2], 4 );	/*remapped to 4*/
+			chan_calc(OPN, cch[3], 5 );	/*remapped to 5*/
 
-			Limit( lt, MAXOUT, MINOUT );
-			Limit( rt, MAXOUT, MINOUT );
+			/* deltaT ADPCM */
+			if( DELTAT->portstate&0x80 )
+				YM_DELTAT_ADPCM_CALC(DELTAT);
 
-			#ifdef SAVE_SAMPLE
-				SAVE_ALL_CHANNELS
-			#endif
+			/* ADPCMA */
+			for( j = 0; j < 6; j++ )
+			{
+				if( F2610->adpcm[j].flag )
+					ADPCMA_calc_chan( F2610, &F2610->adpcm[j]);
+			}
 
 			/* buffering */
-			bufL[i] = lt;
-			bufR[i] = rt;
-		}
+			{
+				int lt,rt;
 
-		/* timer A control */
-		INTERNAL_TIMER_A( &OPN->ST , cch[1] )
+				lt =  out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER];
+				rt =  out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER];
+				lt += (out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9;
+				rt += (out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9;
+
+
+				lt += ((out_fm[1]>>1) & OPN->pan[2]);	/* the shift right was verified on real chip */
+				rt += ((out_fm[1]>>1) & OPN->pan[3]);
+				lt += ((out_fm[2]>>1) & OPN->pan[4]);
+				rt += ((out_fm[2]>>1) & OPN->pan[5]);
+
+				lt += ((out_fm[4]>>1) & OPN->pan[8]);
+				rt += ((out_fm[4]>>1) & OPN->pan[9]);
+				lt += ((out_fm[5]>>1) & OPN->pan[10]);
+				rt += ((out_fm[5]>>1) & OPN->pan[11]);
+
+
+				lt >>= FINAL_SH;
+				rt >>= FINAL_SH;
+
+				Limit( lt, MAXOUT, MINOUT );
+				Limit( rt, MAXOUT, MINOUT );
+
+				#ifdef SAVE_SAMPLE
+					SAVE_ALL_CHANNELS
+				#endif
+
+				/* buffering */
+				bufL[i] = lt;
+				bufR[i] = rt;
+			}
+
+			/* timer A control */
+			INTERNAL_TIMER_A( &OPN->ST , cch[1] )
+		}
 	}
 	INTERNAL_TIMER_B(&OPN->ST,length)
 
@@ -3970,103 +4276,198 @@ void ym2610b_update_one(void *chip, FMSAMPLE **buffer, int length)
 	refresh_fc_eg_chan( OPN, cch[4] );
 	refresh_fc_eg_chan( OPN, cch[5] );
 
-	/* buffering */
-	for(i=0; i < length ; i++)
+	if (fm_block_render)
 	{
+		/* buffering, one block of channel batches at a time */
+		for(i=0; i < length ; i += FM_BLOCK)
+		{
+			static const int chnum[6] = { 0, 1, 2, 3, 4, 5 };
+			int count = MIN(length - i, FM_BLOCK);
 
-		advance_lfo(OPN);
+			opn_prepare_block(OPN, count, 1);
 
-		/* clear output acc. */
-		out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
-		out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
-		/* clear outputs */
-		out_fm[0] = 0;
-		out_fm[1] = 0;
-		out_fm[2] = 0;
-		out_fm[3] = 0;
-		out_fm[4] = 0;
-		out_fm[5] = 0;
+			/* calculate FM */
+			for (j = 0; j < 6; j++)
+				opn_render_channel(OPN, cch[j], chnum[j], blk_out_fm[j], count);
 
-		/* advance envelope generator */
-		OPN->eg_timer += OPN->eg_timer_add;
-		while (OPN->eg_timer >= OPN->eg_timer_overflow)
-		{
-			OPN->eg_timer -= OPN->eg_timer_overflow;
-			OPN->eg_cnt++;
+			/* deltaT ADPCM and ADPCMA */
+			ym2610_render_adpcm(F2610, DELTAT, blk_out_l, blk_out_r, count);
 
-			advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[4]->SLOT[SLOT1]);
-			advance_eg_channel(OPN, &cch[5]->SLOT[SLOT1]);
-		}
-
-		/* calculate FM */
-		chan_calc(OPN, cch[0], 0 );
-		chan_calc(OPN, cch[1], 1 );
-		chan_calc(OPN, cch[2], 2 );
-		chan_calc(OPN, cch[3], 3 );
-		chan_calc(OPN, cch[4], 4 );
-		chan_calc(OPN, cch[5], 5 );
+			/* buffering */
+			opn_mix_block(OPN->pan, chnum, 6, 1, &bufL[i], &bufR[i], blk_out_l, blk_out_r, count);	/* the shift right is verified on YM2610 */
 
-		/* deltaT ADPCM */
-		if( DELTAT->portstate&0x80 )
-			YM_DELTAT_ADPCM_CALC(DELTAT);
+			#ifdef SAVE_SAMPLE
+			for (j = 0; j < count; j++)
+			{
+				int lt = bufL[i + j], rt = bufR[i + j];
+				SAVE_ALL_CHANNELS
+			}
+			#endif
 
-		/* ADPCMA */
-		for( j = 0; j < 6; j++ )
-		{
-			if( F2610->adpcm[j].flag )
-				ADPCMA_calc_chan( F2610, &F2610->adpcm[j]);
+#if FM_INTERNAL_TIMER
+			/* timer A control; a CSM key on lands at the next block */
+			for (j = 0; j < count; j++)
+				INTERNAL_TIMER_A( &OPN->ST , cch[2] )
+#endif
 		}
-
+	}
+	else
+	{
 		/* buffering */
+		for(i=0; i < length ; i++)
 		{
-			int lt,rt;
-
-			lt =  out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER];
-			rt =  out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER];
-			lt += (out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9;
-			rt += (out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9;
-
-			lt += ((out_fm[0]>>1) & OPN->pan[0]);	/* the shift right is verified on YM2610 */
-			rt += ((out_fm[0]>>1) & OPN->pan[1]);
-			lt += ((out_fm[1]>>1) & OPN->pan[2]);
-			rt += ((out_fm[1]>>1) & OPN->pan[3]);
-			lt += ((out_fm[2]>>1) & OPN->pan[4]);
-			rt += ((out_fm[2]>>1) & OPN->pan[5]);
-			lt += ((out_fm[3]>>1) & OPN->pan[6]);
-			rt += ((out_fm[3]>>1) & OPN->pan[7]);
-			lt += ((out_fm[4]>>1) & OPN->pan[8]);
-			rt += ((out_fm[4]>>1) & OPN->pan[9]);
-			lt += ((out_fm[5]>>1) & OPN->pan[10]);
-			rt += ((out_fm[5]>>1) & OPN->pan[11]);
 
+			advance_lfo(OPN);
+
+			/* clear output acc. */
+			out_adpcm[OUTD_LEFT] = out_adpcm[OUTD_RIGHT]= out_adpcm[OUTD_CENTER] = 0;
+			out_delta[OUTD_LEFT] = out_delta[OUTD_RIGHT]= out_delta[OUTD_CENTER] = 0;
+			/* clear outputs */
+			out_fm[0] = 0;
+			out_fm[1] = 0;
+			out_fm[2] = 0;
+			out_fm[3] = 0;
+			out_fm[4] = 0;
+			out_fm[5] = 0;
+
+			/* advance envelope generator */
+			OPN->eg_timer += OPN->eg_timer_add;
+			while (OPN->eg_timer >= OPN->eg_timer_overflow)
+			{
+				OPN->eg_timer -= OPN->eg_timer_overflow;
+				OPN->eg_cnt++;
+
+				advance_eg_channel(OPN, &cch[0]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[1]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[2]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[3]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[4]->SLOT[SLOT1]);
+				advance_eg_channel(OPN, &cch[5]->SLOT[SLOT1]);
+			}
 
-			lt >>= FINAL_SH;
-			rt >>= FINAL_SH;
+			/* calculate FM */
+			chan_calc(OPN, cch[0], 0 );
+			chan_calc(OPN, cch[1], 1 );
+			chan_calc(OPN, cch[2], 2 );
+			chan_calc(OPN, cch[3], 3 );
+			chan_calc(OPN, cch[4], 4 );
+			chan_calc(OPN, cch[5], 5 );
 
-			Limit( lt, MAXOUT, MINOUT );
-			Limit( rt, MAXOUT, MINOUT );
+			/* deltaT ADPCM */
+			if( DELTAT->portstate&0x80 )
+				YM_DELTAT_ADPCM_CALC(DELTAT);
 
-			#ifdef SAVE_SAMPLE
-				SAVE_ALL_CHANNELS
-			#endif
+			/* ADPCMA */
+			for( j = 0; j < 6; j++ )
+			{
+				if( F2610->adpcm[j].flag )
+					ADPCMA_calc_chan( F2610, &F2610->adpcm[j]);
+			}
 
 			/* buffering */
-			bufL[i] = lt;
-			bufR[i] = rt;
-		}
+			{
+				int lt,rt;
+
+				lt =  out_adpcm[OUTD_LEFT]  + out_adpcm[OUTD_CENTER];
+				rt =  out_adpcm[OUTD_RIGHT] + out_adpcm[OUTD_CENTER];
+				lt += (out_delta[OUTD_LEFT]  + out_delta[OUTD_CENTER])>>9;
+				rt += (out_delta[OUTD_RIGHT] + out_delta[OUTD_CENTER])>>9;
+
+				lt += ((out_fm[0]>>1) & OPN->pan[0]);	/* the shift right is verified on YM2610 */
+				rt += ((out_fm[0]>>1) & OPN->pan[1]);
+				lt += ((out_fm[1]>>1) & OPN->pan[2]);
+				rt += ((out_fm[1]>>1) & OPN->pan[3]);
+				lt += ((out_fm[2]>>1) & OPN->pan[4]);
+				rt += ((out_fm[2]>>1) & OPN->pan[5]);
+				lt += ((out_fm[3]>>1) & OPN->pan[6]);
+				rt += ((out_fm[3]>>1) & OPN->pan[7]);
+				lt += ((out_fm[4]>>1) & OPN->pan[8]);
+				rt += ((out_fm[4]>>1) & OPN->pan[9]);
+				lt += ((out_fm[5]>>1) & OPN->pan[10]);
+				rt += ((out_fm[5]>>1) & OPN->pan[11]);
+
+
+				lt >>= FINAL_SH;
+				rt >>= FINAL_SH;
+
+				Limit( lt, MAXOUT, MINOUT );
+				Limit( rt, MAXOUT, MINOUT );
+
+				#ifdef SAVE_SAMPLE
+					SAVE_ALL_CHANNELS
+				#endif
+
+				/* buffering */
+				bufL[i] = lt;
+				bufR[i] = rt;
+			}
 
-		/* timer A control */
-		INTERNAL_TIMER_A( &OPN->ST , cch[2] )
+			/* timer A control */
+			INTERNAL_TIMER_A( &OPN->ST , cch[2] )
+		}
 	}
 	INTERNAL_TIMER_B(&OPN->ST,length)
 
 }
 #endif /* BUILD_YM2610B */
 
+/* the chip is idle when nothing can make a sound before the next register write;
+   channels 0 and 3 only exist on the YM2610B */
+int ym2610_is_idle(void *chip, int is_2610b)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
+	int i;
+
+#if FM_INTERNAL_TIMER
+	/* the timers are clocked by the sample loop */
+	return 0;
+#endif
+	/* CSM keys on from timer A by itself; 3 slot mode is left alone so that
+	   ym2610_skip_idle only has to refresh channels the normal way */
+	if( F2610->OPN.ST.mode & 0xc0 )
+		return 0;
+	if( F2610->deltaT.portstate & 0x80 )
+		return 0;
+	for (i = 0; i < 6; i++)
+	{
+		if( F2610->adpcm[i].flag )
+			return 0;
+		if( (is_2610b || (i != 0 && i != 3)) && !chan_is_idle(&F2610->CH[i]) )
+			return 0;
+	}
+	return 1;
+}
+
+/* catch up on what the updates skipped while idle would have done: the LFO and
+   envelope clock, and any pending frequency refresh; the operators are all off
+   and restart their phase at key on */
+void ym2610_skip_idle(void *chip, int is_2610b, UINT32 length)
+{
+	YM2610 *F2610 = (YM2610 *)chip;
+	FM_OPN *OPN = &F2610->OPN;
+	UINT64 eg_timer;
+	UINT32 ticks;
+	int c,s;
+
+	for (c = 0; c < 6; c++)
+		if (is_2610b || (c != 0 && c != 3))
+			refresh_fc_eg_chan( OPN, &F2610->CH[c] );
+
+	OPN->lfo_cnt += OPN->lfo_inc * length;
+
+	eg_timer = (UINT64)OPN->eg_timer + (UINT64)OPN->eg_timer_add * length;
+	ticks = (UINT32)(eg_timer / OPN->eg_timer_overflow);
+	OPN->eg_timer = (UINT32)(eg_timer % OPN->eg_timer_overflow);
+	OPN->eg_cnt += ticks;
+
+	/* the envelope only refreshes vol_out while off */
+	if (ticks)
+		for (c = 0; c < 6; c++)
+			if (is_2610b || (c != 0 && c != 3))
+				for (s = 0; s < 4; s++)
+					F2610->CH[c].SLOT[s].vol_out = F2610->CH[c].SLOT[s].volume + F2610->CH[c].SLOT[s].tl;
+}
+
 
 #ifdef __STATE_H__
 void ym2610_postload(void *chip)
@@ -26,6 +26,10 @@
 /* busy flag enulation , The definition of FM_GET_TIME_NOW() is necessary. */
 #define FM_BUSY_FLAG_SUPPORT 1
 
+/* render the YM2203/YM2610 channels a block at a time (default) or sample by
+   sample like the original loops; both give the same output */
+extern int fm_block_render;
+
 /* --- external SSG(YM2149/AY-3-8910)emulator interface port */
 /* used by YM2203,YM2608,and YM2610 */
 typedef struct _ssg_callbacks ssg_callbacks;
@@ -194,6 +198,8 @@ void ym2610b_update_one(void *chip, FMSAMPLE **buffer, int length);
 int ym2610_write(void *chip, int a,unsigned char v);
 unsigned char ym2610_read(void *chip,int a);
 int ym2610_timer_over(void *chip, int c );
+int ym2610_is_idle(void *chip, int is_2610b);
+void ym2610_skip_idle(void *chip, int is_2610b, UINT32 length);
 void ym2610_postload(void *chip);
 #endif /* (BUILD_YM2610||BUILD_YM2610B) */
 
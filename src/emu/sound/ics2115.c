@@ -90,55 +90,119 @@ static void recalc_irq(ics2115_state *chip)
 }
 
 
+/* number of samples a voice plays before reaching its end address; 0 if it
+   doesn't get there within 'samples', -1 if the address wraps on the way */
+INLINE int samples_to_end(UINT32 adr, UINT32 end, UINT32 delta, int samples)
+{
+	UINT64 n;
+
+	if (samples == 0)
+		return 0;
+	if (adr >= end)
+		n = 1;
+	else if (delta == 0)
+		return 0;
+	else
+		n = (end - adr + delta - 1) / delta;
+	if (n > samples)
+		return 0;
+	if (adr + n * delta > 0xffffffff)
+		return -1;
+	return n;
+}
+
+/* render a span of one voice into the mix; the span never crosses the end address */
+INLINE UINT32 render_span(ics2115_state *chip, stream_sample_t *mix, int count, UINT32 adr, UINT32 badr, UINT32 delta, UINT8 conf, INT32 vol)
+{
+	const UINT8 *rom = chip->rom;
+	int i;
+
+	if (conf & 1)
+	{
+		const INT16 *ulaw = chip->ulaw;
+		for (i = 0; i < count; i++)
+		{
+			mix[i] += (ulaw[rom[badr|(adr >> 12)]] * vol) >> (16+5);
+			adr += delta;
+		}
+	}
+	else
+	{
+		for (i = 0; i < count; i++)
+		{
+			mix[i] += ((((INT8)rom[badr|(adr >> 12)]) << 6) * vol) >> (16+5);
+			adr += delta;
+		}
+	}
+	return adr;
+}
+
 static STREAM_UPDATE( update )
 {
 	ics2115_state *chip = (ics2115_state *)param;
-	int osc, i;
+	UINT8 active[32];
+	int osc, i, numactive = 0;
 	int rec_irq = 0;
 
 	memset(outputs[0], 0, samples*sizeof(*outputs[0]));
-	memset(outputs[1], 0, samples*sizeof(*outputs[0]));
 
+	/* gather the voices that are playing */
 	for (osc = 0; osc < 32; osc++)
 		if (chip->voice[osc].state & V_ON)
+			active[numactive++] = osc;
+
+	for (i = 0; i < numactive; i++)
+	{
+		UINT32 adr, end, loop, badr, delta;
+		UINT8 conf;
+		INT32 vol;
+		int count;
+
+		osc = active[i];
+		adr = (chip->voice[osc].addrh << 16) | chip->voice[osc].addrl;
+		end = (chip->voice[osc].endh << 16) | (chip->voice[osc].endl << 8);
+		loop = (chip->voice[osc].strth << 16) | (chip->voice[osc].strtl << 8);
+		badr = (chip->voice[osc].saddr << 20) & 0xffffff;
+		delta = chip->voice[osc].fc << 2;
+		conf = chip->voice[osc].conf;
+		vol = chip->voice[osc].volacc;
+		vol = (((vol & 0xff0)|0x1000)<<(vol>>12))>>12;
+
+		if (ICS2115LOGERROR) logerror("ICS2115: KEYRUN %02d adr=%08x end=%08x delta=%08x\n",
+				 osc, adr, end, delta);
+
+		/* play up to the end address (or the whole buffer) in one span */
+		count = samples_to_end(adr, end, delta, samples);
+		if (count >= 0)
+			adr = render_span(chip, outputs[0], count ? count : samples, adr, badr, delta, conf, vol);
+		else
 		{
-			UINT32 adr = (chip->voice[osc].addrh << 16) | chip->voice[osc].addrl;
-			UINT32 end = (chip->voice[osc].endh << 16) | (chip->voice[osc].endl << 8);
-			UINT32 loop = (chip->voice[osc].strth << 16) | (chip->voice[osc].strtl << 8);
-			UINT32 badr = (chip->voice[osc].saddr << 20) & 0xffffff;
-			UINT32 delta = chip->voice[osc].fc << 2;
-			UINT8 conf = chip->voice[osc].conf;
-			INT32 vol = chip->voice[osc].volacc;
-			vol = (((vol & 0xff0)|0x1000)<<(vol>>12))>>12;
-
-			if (ICS2115LOGERROR) logerror("ICS2115: KEYRUN %02d adr=%08x end=%08x delta=%08x\n",
-					 osc, adr, end, delta);
-
-			for (i = 0; i < samples; i++)
+			/* the address wraps on the way to the end; go a sample at a time */
+			for (count = 1; count <= samples; count++)
 			{
-				INT32 v = chip->rom[badr|(adr >> 12)];
-				if (conf & 1)
-					v = chip->ulaw[v];
-				else
-					v = ((INT8)v) << 6;
-
-				v = (v*vol)>>(16+5);
-				outputs[0][i] += v;
-				outputs[1][i] += v;
-				adr += delta;
+				adr = render_span(chip, &outputs[0][count - 1], 1, adr, badr, delta, conf, vol);
 				if (adr >= end)
-				{
-					if (ICS2115LOGERROR) logerror("ICS2115: KEYDONE %2d\n", osc);
-					adr -= (end-loop);
-					chip->voice[osc].state &= ~V_ON;
-					chip->voice[osc].state |= V_DONE;
-					rec_irq = 1;
 					break;
-				}
 			}
-			chip->voice[osc].addrh = adr >> 16;
-			chip->voice[osc].addrl = adr;
+			if (count > samples)
+				count = 0;
+		}
+
+		if (count != 0)
+		{
+			if (ICS2115LOGERROR) logerror("ICS2115: KEYDONE %2d\n", osc);
+			adr -= (end-loop);
+			chip->voice[osc].state &= ~V_ON;
+			chip->voice[osc].state |= V_DONE;
+			rec_irq = 1;
 		}
+		chip->voice[osc].addrh = adr >> 16;
+		chip->voice[osc].addrl = adr;
+	}
+
+	/* the chip is mono; both outputs carry the same mix */
+	memcpy(outputs[1], outputs[0], samples*sizeof(*outputs[0]));
+
 	if (rec_irq)
 		recalc_irq(chip);
 }
@@ -569,6 +633,7 @@ READ8_DEVICE_HANDLER( ics2115_r )
 WRITE8_DEVICE_HANDLER( ics2115_w )
 {
 	ics2115_state *chip = get_safe_token(device);
+	sound_log_write(device, offset, data);
 	switch (offset)
 	{
 	case 1:
@@ -147,6 +147,7 @@ WRITE8_DEVICE_HANDLER( irem_ga20_w )
 	int channel;
 
 	//logerror("GA20:  Offset %02x, data %04x\n",offset,data);
+	sound_log_write(device, offset, data);
 
 	stream_update(chip->stream);
 
@@ -17,6 +17,7 @@
 #include "emu.h"
 #include "streams.h"
 #include "msm5205.h"
+#include "okim6295.h"
 
 /*
  *
@@ -41,9 +42,7 @@ struct _msm5205_state
 	INT32 reset;              /* reset pin signal             */
 	INT32 prescaler;          /* prescaler selector S1 and S2 */
 	INT32 bitwidth;           /* bit width selector -3B/4B    */
-	INT32 signal;             /* current ADPCM signal         */
-	INT32 step;               /* current ADPCM step           */
-	int diff_lookup[49*16];
+	adpcm_state adpcm;        /* signal/step; same decoder as the OKIM6295 */
 };
 
 INLINE msm5205_state *get_safe_token(running_device *device)
@@ -56,48 +55,6 @@ INLINE msm5205_state *get_safe_token(running_device *device)
 
 static void msm5205_playmode(msm5205_state *voice,int select);
 
-/*
- * ADPCM lockup tabe
- */
-
-/* step size index shift table */
-static const int index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
-
-/*
- *   Compute the difference table
- */
-
-static void ComputeTables (msm5205_state *voice)
-{
-	/* nibble to bit map */
-	static const int nbl2bit[16][4] =
-	{
-		{ 1, 0, 0, 0}, { 1, 0, 0, 1}, { 1, 0, 1, 0}, { 1, 0, 1, 1},
-		{ 1, 1, 0, 0}, { 1, 1, 0, 1}, { 1, 1, 1, 0}, { 1, 1, 1, 1},
-		{-1, 0, 0, 0}, {-1, 0, 0, 1}, {-1, 0, 1, 0}, {-1, 0, 1, 1},
-		{-1, 1, 0, 0}, {-1, 1, 0, 1}, {-1, 1, 1, 0}, {-1, 1, 1, 1}
-	};
-
-	int step, nib;
-
-	/* loop over all possible steps */
-	for (step = 0; step <= 48; step++)
-	{
-		/* compute the step value */
-		int stepval = floor (16.0 * pow (11.0 / 10.0, (double)step));
-
-		/* loop over all nibbles and compute the difference */
-		for (nib = 0; nib < 16; nib++)
-		{
-			voice->diff_lookup[step*16 + nib] = nbl2bit[nib][0] *
-				(stepval   * nbl2bit[nib][1] +
-				 stepval/2 * nbl2bit[nib][2] +
-				 stepval/4 * nbl2bit[nib][3] +
-				 stepval/8);
-		}
-	}
-}
-
 /* stream update callbacks */
 static STREAM_UPDATE( MSM5205_update )
 {
@@ -105,9 +62,9 @@ static STREAM_UPDATE( MSM5205_update )
 	stream_sample_t *buffer = outputs[0];
 
 	/* if this voice is active */
-	if(voice->signal)
+	if(voice->adpcm.m_signal)
 	{
-		short val = voice->signal * 16;
+		short val = voice->adpcm.m_signal * 16;
 		while (samples)
 		{
 			*buffer++ = val;
@@ -115,14 +72,17 @@ static STREAM_UPDATE( MSM5205_update )
 		}
 	}
 	else
+	{
 		memset (buffer,0,samples*sizeof(*buffer));
+		/* silent until the signal moves again */
+		stream_set_idle(voice->stream);
+	}
 }
 
 /* timer callback at VCLK low eddge */
 static TIMER_CALLBACK( MSM5205_vclk_callback )
 {
 	msm5205_state *voice = (msm5205_state *)ptr;
-	int val;
 	int new_signal;
 	/* callback user handler and latch next data */
 	if(voice->intf->vclk_callback) (*voice->intf->vclk_callback)(voice->device);
@@ -131,25 +91,23 @@ static TIMER_CALLBACK( MSM5205_vclk_callback )
 	if(voice->reset)
 	{
 		new_signal = 0;
-		voice->step = 0;
+		voice->adpcm.m_step = 0;
 	}
 	else
 	{
 		/* update signal */
 		/* !! MSM5205 has internal 12bit decoding, signal width is 0 to 8191 !! */
-		val = voice->data;
-		new_signal = voice->signal + voice->diff_lookup[voice->step * 16 + (val & 15)];
-		if (new_signal > 2047) new_signal = 2047;
-		else if (new_signal < -2048) new_signal = -2048;
-		voice->step += index_shift[val & 7];
-		if (voice->step > 48) voice->step = 48;
-		else if (voice->step < 0) voice->step = 0;
+		/* decode on a copy; the signal only moves once the stream has caught up */
+		adpcm_state next = voice->adpcm;
+		new_signal = next.clock(voice->data);
+		voice->adpcm.m_step = next.m_step;
 	}
 	/* update when signal changed */
-	if( voice->signal != new_signal)
+	if( voice->adpcm.m_signal != new_signal)
 	{
 		stream_update(voice->stream);
-		voice->signal = new_signal;
+		stream_wake(voice->stream);
+		voice->adpcm.m_signal = new_signal;
 	}
 }
 
@@ -164,10 +122,12 @@ static DEVICE_RESET( msm5205 )
 	voice->data    = 0;
 	voice->vclk    = 0;
 	voice->reset   = 0;
-	voice->signal  = 0;
-	voice->step    = 0;
+	voice->adpcm.m_signal = 0;
+	voice->adpcm.m_step   = 0;
 	/* timer and bitwidth set */
 	msm5205_playmode(voice,voice->intf->select);
+	/* a replay of the sound log starts in the same mode */
+	sound_log_write(device, MSM5205_LOG_PLAYMODE, voice->intf->select);
 }
 
 
@@ -184,9 +144,6 @@ static DEVICE_START( msm5205 )
 	voice->device = device;
 	voice->clock = device->clock();
 
-	/* compute the difference tables */
-	ComputeTables (voice);
-
 	/* stream system initialize */
 	voice->stream = stream_create(device,0,1,device->clock(),voice,MSM5205_update);
 	voice->timer = timer_alloc(device->machine, MSM5205_vclk_callback, voice);
@@ -201,8 +158,8 @@ static DEVICE_START( msm5205 )
 	state_save_register_device_item(device, 0, voice->reset);
 	state_save_register_device_item(device, 0, voice->prescaler);
 	state_save_register_device_item(device, 0, voice->bitwidth);
-	state_save_register_device_item(device, 0, voice->signal);
-	state_save_register_device_item(device, 0, voice->step);
+	state_save_register_device_item(device, 0, voice->adpcm.m_signal);
+	state_save_register_device_item(device, 0, voice->adpcm.m_step);
 }
 
 /*
@@ -213,6 +170,8 @@ void msm5205_vclk_w (running_device *device, int vclk)
 {
 	msm5205_state *voice = get_safe_token(device);
 
+	sound_log_write(device, MSM5205_LOG_VCLK, vclk);
+
 	if( voice->prescaler != 0 )
 	{
 		logerror("error: msm5205_vclk_w() called with chip = '%s', but VCLK selected master mode\n", device->tag());
@@ -234,6 +193,7 @@ void msm5205_vclk_w (running_device *device, int vclk)
 void msm5205_reset_w (running_device *device, int reset)
 {
 	msm5205_state *voice = get_safe_token(device);
+	sound_log_write(device, MSM5205_LOG_RESET, reset);
 	voice->reset = reset;
 }
 
@@ -244,6 +204,7 @@ void msm5205_reset_w (running_device *device, int reset)
 void msm5205_data_w (running_device *device, int data)
 {
 	msm5205_state *voice = get_safe_token(device);
+	sound_log_write(device, MSM5205_LOG_DATA, data);
 	if( voice->bitwidth == 4)
 		voice->data = data & 0x0f;
 	else
@@ -257,6 +218,7 @@ void msm5205_data_w (running_device *device, int data)
 void msm5205_playmode_w(running_device *device, int select)
 {
 	msm5205_state *voice = get_safe_token(device);
+	sound_log_write(device, MSM5205_LOG_PLAYMODE, select);
 	msm5205_playmode(voice,select);
 }
 
@@ -25,6 +25,15 @@ struct _msm5205_interface
 	int select;       /* prescaler / bit width selector        */
 };
 
+/* sound log ports, one for each of the functions below */
+enum
+{
+	MSM5205_LOG_RESET,
+	MSM5205_LOG_DATA,
+	MSM5205_LOG_VCLK,
+	MSM5205_LOG_PLAYMODE
+};
+
 /* reset signal should keep for 2cycle of VCLK      */
 void msm5205_reset_w (running_device *device, int reset);
 /* adpcmata is latched after vclk_interrupt callback */
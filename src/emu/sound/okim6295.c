@@ -45,9 +45,62 @@
 //**************************************************************************
 
 // ADPCM state and tables
-bool adpcm_state::s_tables_computed = false;
 const INT8 adpcm_state::s_index_shift[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
-int adpcm_state::s_diff_lookup[49*16];
+
+// signal difference for each step and nibble; the step value is floor(16 * 1.1^step),
+// and a nibble sbbb adds (-1)^s * (step*b2 + step/2*b1 + step/4*b0 + step/8)
+const INT16 adpcm_state::s_diff_lookup[49*16] =
+{
+	2, 6, 10, 14, 18, 22, 26, 30, -2, -6, -10, -14, -18, -22, -26, -30,	// step 0 (16)
+	2, 6, 10, 14, 19, 23, 27, 31, -2, -6, -10, -14, -19, -23, -27, -31,	// step 1 (17)
+	2, 6, 11, 15, 21, 25, 30, 34, -2, -6, -11, -15, -21, -25, -30, -34,	// step 2 (19)
+	2, 7, 12, 17, 23, 28, 33, 38, -2, -7, -12, -17, -23, -28, -33, -38,	// step 3 (21)
+	2, 7, 13, 18, 25, 30, 36, 41, -2, -7, -13, -18, -25, -30, -36, -41,	// step 4 (23)
+	3, 9, 15, 21, 28, 34, 40, 46, -3, -9, -15, -21, -28, -34, -40, -46,	// step 5 (25)
+	3, 10, 17, 24, 31, 38, 45, 52, -3, -10, -17, -24, -31, -38, -45, -52,	// step 6 (28)
+	3, 10, 18, 25, 34, 41, 49, 56, -3, -10, -18, -25, -34, -41, -49, -56,	// step 7 (31)
+	4, 12, 21, 29, 38, 46, 55, 63, -4, -12, -21, -29, -38, -46, -55, -63,	// step 8 (34)
+	4, 13, 22, 31, 41, 50, 59, 68, -4, -13, -22, -31, -41, -50, -59, -68,	// step 9 (37)
+	5, 15, 25, 35, 46, 56, 66, 76, -5, -15, -25, -35, -46, -56, -66, -76,	// step 10 (41)
+	5, 16, 27, 38, 50, 61, 72, 83, -5, -16, -27, -38, -50, -61, -72, -83,	// step 11 (45)
+	6, 18, 31, 43, 56, 68, 81, 93, -6, -18, -31, -43, -56, -68, -81, -93,	// step 12 (50)
+	6, 19, 33, 46, 61, 74, 88, 101, -6, -19, -33, -46, -61, -74, -88, -101,	// step 13 (55)
+	7, 22, 37, 52, 67, 82, 97, 112, -7, -22, -37, -52, -67, -82, -97, -112,	// step 14 (60)
+	8, 24, 41, 57, 74, 90, 107, 123, -8, -24, -41, -57, -74, -90, -107, -123,	// step 15 (66)
+	9, 27, 45, 63, 82, 100, 118, 136, -9, -27, -45, -63, -82, -100, -118, -136,	// step 16 (73)
+	10, 30, 50, 70, 90, 110, 130, 150, -10, -30, -50, -70, -90, -110, -130, -150,	// step 17 (80)
+	11, 33, 55, 77, 99, 121, 143, 165, -11, -33, -55, -77, -99, -121, -143, -165,	// step 18 (88)
+	12, 36, 60, 84, 109, 133, 157, 181, -12, -36, -60, -84, -109, -133, -157, -181,	// step 19 (97)
+	13, 39, 66, 92, 120, 146, 173, 199, -13, -39, -66, -92, -120, -146, -173, -199,	// step 20 (107)
+	14, 43, 73, 102, 132, 161, 191, 220, -14, -43, -73, -102, -132, -161, -191, -220,	// step 21 (118)
+	16, 48, 81, 113, 146, 178, 211, 243, -16, -48, -81, -113, -146, -178, -211, -243,	// step 22 (130)
+	17, 52, 88, 123, 160, 195, 231, 266, -17, -52, -88, -123, -160, -195, -231, -266,	// step 23 (143)
+	19, 58, 97, 136, 176, 215, 254, 293, -19, -58, -97, -136, -176, -215, -254, -293,	// step 24 (157)
+	21, 64, 107, 150, 194, 237, 280, 323, -21, -64, -107, -150, -194, -237, -280, -323,	// step 25 (173)
+	23, 70, 118, 165, 213, 260, 308, 355, -23, -70, -118, -165, -213, -260, -308, -355,	// step 26 (190)
+	26, 78, 130, 182, 235, 287, 339, 391, -26, -78, -130, -182, -235, -287, -339, -391,	// step 27 (209)
+	28, 85, 143, 200, 258, 315, 373, 430, -28, -85, -143, -200, -258, -315, -373, -430,	// step 28 (230)
+	31, 94, 157, 220, 284, 347, 410, 473, -31, -94, -157, -220, -284, -347, -410, -473,	// step 29 (253)
+	34, 103, 173, 242, 313, 382, 452, 521, -34, -103, -173, -242, -313, -382, -452, -521,	// step 30 (279)
+	38, 114, 191, 267, 345, 421, 498, 574, -38, -114, -191, -267, -345, -421, -498, -574,	// step 31 (307)
+	42, 126, 210, 294, 379, 463, 547, 631, -42, -126, -210, -294, -379, -463, -547, -631,	// step 32 (337)
+	46, 138, 231, 323, 417, 509, 602, 694, -46, -138, -231, -323, -417, -509, -602, -694,	// step 33 (371)
+	51, 153, 255, 357, 459, 561, 663, 765, -51, -153, -255, -357, -459, -561, -663, -765,	// step 34 (408)
+	56, 168, 280, 392, 505, 617, 729, 841, -56, -168, -280, -392, -505, -617, -729, -841,	// step 35 (449)
+	61, 184, 308, 431, 555, 678, 802, 925, -61, -184, -308, -431, -555, -678, -802, -925,	// step 36 (494)
+	68, 204, 340, 476, 612, 748, 884, 1020, -68, -204, -340, -476, -612, -748, -884, -1020,	// step 37 (544)
+	74, 223, 373, 522, 672, 821, 971, 1120, -74, -223, -373, -522, -672, -821, -971, -1120,	// step 38 (598)
+	82, 246, 411, 575, 740, 904, 1069, 1233, -82, -246, -411, -575, -740, -904, -1069, -1233,	// step 39 (658)
+	90, 271, 452, 633, 814, 995, 1176, 1357, -90, -271, -452, -633, -814, -995, -1176, -1357,	// step 40 (724)
+	99, 298, 497, 696, 895, 1094, 1293, 1492, -99, -298, -497, -696, -895, -1094, -1293, -1492,	// step 41 (796)
+	109, 328, 547, 766, 985, 1204, 1423, 1642, -109, -328, -547, -766, -985, -1204, -1423, -1642,	// step 42 (876)
+	120, 360, 601, 841, 1083, 1323, 1564, 1804, -120, -360, -601, -841, -1083, -1323, -1564, -1804,	// step 43 (963)
+	132, 397, 662, 927, 1192, 1457, 1722, 1987, -132, -397, -662, -927, -1192, -1457, -1722, -1987,	// step 44 (1060)
+	145, 436, 728, 1019, 1311, 1602, 1894, 2185, -145, -436, -728, -1019, -1311, -1602, -1894, -2185,	// step 45 (1166)
+	160, 480, 801, 1121, 1442, 1762, 2083, 2403, -160, -480, -801, -1121, -1442, -1762, -2083, -2403,	// step 46 (1282)
+	176, 528, 881, 1233, 1587, 1939, 2292, 2644, -176, -528, -881, -1233, -1587, -1939, -2292, -2644,	// step 47 (1411)
+	194, 582, 970, 1358, 1746, 2134, 2522, 2910, -194, -582, -970, -1358, -1746, -2134, -2522, -2910,	// step 48 (1552)
+};
 
 // volume lookup table. The manual lists only 9 steps, ~3dB per step. Given the dB values,
 // that seems to map to a 5-bit volume control. Any volume parameter beyond the 9th index
@@ -199,6 +252,10 @@ void okim6295_device::device_start()
 
 void okim6295_device::device_reset()
 {
+	// a replay of the sound log starts from the bank and rate set up so far
+	sound_log_write(this, OKIM6295_LOG_BANK_BASE, m_bank_offs);
+	sound_log_write(this, OKIM6295_LOG_PIN7, m_pin7_state);
+
 	stream_update(m_stream);
 	for (int voicenum = 0; voicenum < OKIM6295_VOICES; voicenum++)
 		m_voice[voicenum].m_playing = false;
@@ -243,8 +300,16 @@ void okim6295_device::stream_generate(stream_sample_t **inputs, stream_sample_t
 	memset(outputs[0], 0, samples * sizeof(*outputs[0]));
 
 	// iterate over voices and accumulate sample data
+	bool playing = false;
 	for (int voicenum = 0; voicenum < OKIM6295_VOICES; voicenum++)
+	{
 		m_voice[voicenum].generate_adpcm(*m_direct, outputs[0], samples);
+		playing |= m_voice[voicenum].m_playing;
+	}
+
+	// nothing more to generate until a voice is started
+	if (!playing)
+		stream_set_idle(m_stream);
 }
 
 
@@ -255,6 +320,8 @@ void okim6295_device::stream_generate(stream_sample_t **inputs, stream_sample_t
 
 void okim6295_device::set_bank_base(offs_t base)
 {
+	sound_log_write(this, OKIM6295_LOG_BANK_BASE, base);
+
 	// flush out anything pending
 	stream_update(m_stream);
 
@@ -282,6 +349,7 @@ void okim6295_device::set_bank_base(offs_t base)
 
 void okim6295_device::set_pin7(int pin7)
 {
+	sound_log_write(this, OKIM6295_LOG_PIN7, pin7);
 	m_pin7_state = pin7;
 	device_clock_changed();
 }
@@ -321,6 +389,8 @@ WRITE8_DEVICE_HANDLER( okim6295_w )
 
 WRITE8_MEMBER( okim6295_device::write )
 {
+	sound_log_write(this, 0, data);
+
 	// if a command is pending, process the second half
 	if (m_command != -1)
 	{
@@ -356,6 +426,7 @@ WRITE8_MEMBER( okim6295_device::write )
 				{
 					if (!voice.m_playing) // fixes Got-cha and Steel Force
 					{
+						stream_wake(m_stream);
 						voice.m_playing = true;
 						voice.m_base_offset = start;
 						voice.m_sample = 0;
@@ -430,23 +501,37 @@ void okim6295_device::okim_voice::generate_adpcm(direct_read_data &direct, strea
 	if (!m_playing)
 		return;
 
-	// loop while we still have samples to generate
-	while (samples-- != 0)
+	// never run past the end of the sample
+	int count = MIN(samples, m_count - m_sample);
+	int remaining = count;
+
+	// output to the buffer, scaling by the volume
+	// signal in range -2048..2047, volume in range 2..32 => signal * volume / 2 in range -32768..32767
+
+	// an odd sample finishes off the low nibble of the current byte
+	if ((m_sample & 1) && remaining > 0)
+	{
+		*buffer++ += m_adpcm.clock(direct.read_raw_byte(m_base_offset + m_sample / 2)) * m_volume / 2;
+		remaining--;
+	}
+
+	// then whole bytes, high nibble first, fetching each byte once
+	offs_t offset = m_base_offset + (m_sample + 1) / 2;
+	for ( ; remaining >= 2; remaining -= 2)
 	{
-		// fetch the next sample byte
-		int nibble = direct.read_raw_byte(m_base_offset + m_sample / 2) >> (((m_sample & 1) << 2) ^ 4);
-
-		// output to the buffer, scaling by the volume
-		// signal in range -2048..2047, volume in range 2..32 => signal * volume / 2 in range -32768..32767
-		*buffer++ += m_adpcm.clock(nibble) * m_volume / 2;
-
-		// next!
-		if (++m_sample >= m_count)
-		{
-			m_playing = false;
-			break;
-		}
+		UINT8 data = direct.read_raw_byte(offset++);
+		*buffer++ += m_adpcm.clock(data >> 4) * m_volume / 2;
+		*buffer++ += m_adpcm.clock(data) * m_volume / 2;
 	}
+
+	// and a final high nibble
+	if (remaining > 0)
+		*buffer++ += m_adpcm.clock(direct.read_raw_byte(offset) >> 4) * m_volume / 2;
+
+	// next!
+	m_sample += count;
+	if (m_sample >= m_count)
+		m_playing = false;
 }
 
 
@@ -494,44 +579,4 @@ INT16 adpcm_state::clock(UINT8 nibble)
 	return m_signal;
 }
 
-
-//-------------------------------------------------
-//  compute_tables - precompute tables for faster
-//  sound generation
-//-------------------------------------------------
-
-void adpcm_state::compute_tables()
-{
-	// skip if we already did it
-	if (s_tables_computed)
-		return;
-	s_tables_computed = true;
-
-	// nibble to bit map
-	static const INT8 nbl2bit[16][4] =
-	{
-		{ 1, 0, 0, 0}, { 1, 0, 0, 1}, { 1, 0, 1, 0}, { 1, 0, 1, 1},
-		{ 1, 1, 0, 0}, { 1, 1, 0, 1}, { 1, 1, 1, 0}, { 1, 1, 1, 1},
-		{-1, 0, 0, 0}, {-1, 0, 0, 1}, {-1, 0, 1, 0}, {-1, 0, 1, 1},
-		{-1, 1, 0, 0}, {-1, 1, 0, 1}, {-1, 1, 1, 0}, {-1, 1, 1, 1}
-	};
-
-	// loop over all possible steps
-	for (int step = 0; step <= 48; step++)
-	{
-		// compute the step value
-		int stepval = floor(16.0 * pow(11.0 / 10.0, (double)step));
-
-		// loop over all nibbles and compute the difference
-		for (int nib = 0; nib < 16; nib++)
-		{
-			s_diff_lookup[step*16 + nib] = nbl2bit[nib][0] *
-				(stepval   * nbl2bit[nib][1] +
-				 stepval/2 * nbl2bit[nib][2] +
-				 stepval/4 * nbl2bit[nib][3] +
-				 stepval/8);
-		}
-	}
-}
-
 const device_type SOUND_OKIM6295 = okim6295_device_config::static_alloc_device_config;
@@ -25,6 +25,13 @@ enum
 	OKIM6295_PIN7_HIGH = 1
 };
 
+// sound log ports; writes to the command register are logged as port 0
+enum
+{
+	OKIM6295_LOG_BANK_BASE = 0x100,
+	OKIM6295_LOG_PIN7
+};
+
 
 
 //**************************************************************************
@@ -55,7 +62,7 @@ enum
 class adpcm_state
 {
 public:
-	adpcm_state() { compute_tables(); reset(); }
+	adpcm_state() { reset(); }
 
 	void reset();
 	INT16 clock(UINT8 nibble);
@@ -65,10 +72,7 @@ public:
 
 private:
 	static const INT8 s_index_shift[8];
-	static int s_diff_lookup[49*16];
-
-	static void compute_tables();
-	static bool s_tables_computed;
+	static const INT16 s_diff_lookup[49*16];
 };
 
 
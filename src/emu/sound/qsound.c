@@ -35,6 +35,12 @@
 #include "streams.h"
 #include "qsound.h"
 
+#if (defined(__SSE2__) && defined(PTR64))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 /*
 Debug defines
 */
@@ -48,6 +54,7 @@ typedef INT8 QSOUND_SRC_SAMPLE;
 
 #define QSOUND_CLOCKDIV 166			 /* Clock divider */
 #define QSOUND_CHANNELS 16
+#define QSOUND_BLOCK	256			 /* Samples rendered per voice pass */
 typedef stream_sample_t QSOUND_SAMPLE;
 
 struct QSOUND_CHANNEL
@@ -81,6 +88,8 @@ struct _qsound_state
 	QSOUND_SRC_SAMPLE  *sample_rom;			/* Q sound sample ROM */
 	UINT32 sample_rom_length;
 
+	INT32 voice[QSOUND_BLOCK];			/* Rendered voice scratch buffer */
+
 	int pan_table[33];				/* Pan volume table */
 	float frq_ratio;				/* Frequency ratio */
 
@@ -173,6 +182,8 @@ static DEVICE_STOP( qsound )
 WRITE8_DEVICE_HANDLER( qsound_w )
 {
 	qsound_state *chip = get_safe_token(device);
+
+	sound_log_write(device, offset, data);
 	switch (offset)
 	{
 		case 0:
@@ -312,12 +323,148 @@ static void qsound_set_command(qsound_state *chip, int data, int value)
 }
 
 
+/*
+    Voice rendering works on spans instead of single samples. The channel
+    position is a 16.16 fixed point phase, and the number of output samples
+    before the address moves, or before the end check fires, can be computed
+    up front. Each span is then a plain ROM fetch loop, and the loop/end
+    handling only runs once per boundary. The result matches the original
+    per-sample stepping exactly.
+*/
+
+/* number of steps of 'pitch' from 'phase' that stay below 'limit', capped at 'max' */
+INLINE int qsound_steps_below(UINT64 phase, UINT64 limit, UINT32 pitch, int max)
+{
+	if (phase >= limit)
+		return 0;
+	if (pitch == 0)
+		return max;
+	UINT64 steps = (limit - phase + pitch - 1) / pitch;
+	return (steps < (UINT64)max) ? (int)steps : max;
+}
+
+/* render a keyed-on channel into dest; returns the number of samples written
+   before the channel reached the end of a non-looped sample */
+static int qsound_render_voice(qsound_state *chip, struct QSOUND_CHANNEL *pC, INT32 *dest, int samples)
+{
+	const QSOUND_SRC_SAMPLE *rom = chip->sample_rom;
+	UINT32 length = chip->sample_rom_length;
+	UINT32 pitch = pC->pitch;
+	int pos = 0;
+
+	while (pos < samples)
+	{
+		UINT32 base = pC->address;
+		UINT64 phase = ((UINT64)base << 16) + (UINT32)pC->offset;
+		UINT32 target = MAX((UINT32)pC->end, base + 1);
+		int avail = samples - pos;
+		int hold, span, i;
+
+		/* until the address moves, the last fetched value is repeated */
+		hold = qsound_steps_below(phase, (UINT64)(base + 1) << 16, pitch, avail);
+		/* past the end address (or past the current one if already beyond it) the end check fires */
+		span = qsound_steps_below(phase, (UINT64)target << 16, pitch, avail);
+
+		for (i = 0; i < hold; i++)
+			dest[pos + i] = pC->lastdt;
+
+		if (span > hold)
+		{
+			/* phase relative to the start address stays below 2^32 within the span */
+			UINT32 rel = (UINT32)(phase - ((UINT64)base << 16)) + hold * pitch;
+			UINT32 last = pC->bank + base + (UINT32)(((phase - ((UINT64)base << 16)) + (UINT64)(span - 1) * pitch) >> 16);
+
+			if (last < length)
+			{
+				const QSOUND_SRC_SAMPLE *src = rom + pC->bank + base;
+				for (i = hold; i < span; i++, rel += pitch)
+					dest[pos + i] = src[rel >> 16];
+			}
+			else
+			{
+				for (i = hold; i < span; i++, rel += pitch)
+					dest[pos + i] = rom[(pC->bank + base + (rel >> 16)) % length];
+			}
+			pC->lastdt = dest[pos + span - 1];
+		}
+		pos += span;
+
+		if (span == avail)
+		{
+			/* ran out of output: leave the state as the per-sample loop would */
+			UINT64 lastphase = phase + (UINT64)(span - 1) * pitch;
+			pC->address = (INT32)(lastphase >> 16);
+			pC->offset = (INT32)(lastphase & 0xffff) + pitch;
+			break;
+		}
+
+		/* the next sample crosses the end address */
+		phase += (UINT64)span * pitch;
+		if (!pC->loop)
+		{
+			/* Reached the end of a non-looped sample */
+			pC->address = (INT32)(phase >> 16);
+			pC->offset = (INT32)(phase & 0xffff);
+			pC->key = 0;
+			break;
+		}
+
+		/* Reached the end, restart the loop */
+		pC->address = (pC->end - pC->loop) & 0xffff;
+		pC->lastdt = rom[(pC->bank + pC->address) % length];
+		pC->offset = (INT32)(phase & 0xffff) + pitch;
+		dest[pos++] = pC->lastdt;
+	}
+
+	return pos;
+}
+
+/* accumulate a rendered voice into both outputs */
+static void qsound_mix_voice(stream_sample_t *outl, stream_sample_t *outr, const INT32 *voice, int samples, int lvol, int rvol)
+{
+	int i = 0;
+
+#if (defined(__SSE2__) && defined(PTR64))
+	/* voice samples are 8 bit and volumes 16 bit unsigned, so v * vol is
+	   computed as (v << 8) * (vol >> 8) + v * (vol & 0xff) with pmaddwd */
+	const __m128i lmul = _mm_set1_epi32(((lvol & 0xff) << 16) | (lvol >> 8));
+	const __m128i rmul = _mm_set1_epi32(((rvol & 0xff) << 16) | (rvol >> 8));
+	const __m128i lowmask = _mm_set1_epi32(0xffff);
+
+	for ( ; i + 4 <= samples; i += 4)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *)&voice[i]);
+		__m128i pair = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_and_si128(_mm_slli_epi32(v, 8), lowmask));
+		__m128i l = _mm_loadu_si128((const __m128i *)&outl[i]);
+		__m128i r = _mm_loadu_si128((const __m128i *)&outr[i]);
+
+		l = _mm_add_epi32(l, _mm_srai_epi32(_mm_madd_epi16(pair, lmul), 6));
+		r = _mm_add_epi32(r, _mm_srai_epi32(_mm_madd_epi16(pair, rmul), 6));
+		_mm_storeu_si128((__m128i *)&outl[i], l);
+		_mm_storeu_si128((__m128i *)&outr[i], r);
+	}
+#elif defined(__ARM_NEON__)
+	for ( ; i + 4 <= samples; i += 4)
+	{
+		int32x4_t v = vld1q_s32(&voice[i]);
+
+		vst1q_s32(&outl[i], vaddq_s32(vld1q_s32(&outl[i]), vshrq_n_s32(vmulq_n_s32(v, lvol), 6)));
+		vst1q_s32(&outr[i], vaddq_s32(vld1q_s32(&outr[i]), vshrq_n_s32(vmulq_n_s32(v, rvol), 6)));
+	}
+#endif
+
+	for ( ; i < samples; i++)
+	{
+		outl[i] += ((voice[i] * lvol) >> 6);
+		outr[i] += ((voice[i] * rvol) >> 6);
+	}
+}
+
+
 static STREAM_UPDATE( qsound_update )
 {
 	qsound_state *chip = (qsound_state *)param;
-	int i,j;
-	int rvol, lvol, count;
-	struct QSOUND_CHANNEL *pC=&chip->channel[0];
+	int i, block;
 	stream_sample_t  *datap[2];
 
 	datap[0] = outputs[0];
@@ -325,44 +472,22 @@ static STREAM_UPDATE( qsound_update )
 	memset( datap[0], 0x00, samples * sizeof(*datap[0]) );
 	memset( datap[1], 0x00, samples * sizeof(*datap[1]) );
 
-	for (i=0; i<QSOUND_CHANNELS; i++)
+	for (block = 0; block < samples; block += QSOUND_BLOCK)
 	{
-		if (pC->key)
-		{
-			QSOUND_SAMPLE *pOutL=datap[0];
-			QSOUND_SAMPLE *pOutR=datap[1];
-			rvol=(pC->rvol*pC->vol)>>8;
-			lvol=(pC->lvol*pC->vol)>>8;
+		int count = MIN(samples - block, QSOUND_BLOCK);
+		struct QSOUND_CHANNEL *pC = &chip->channel[0];
 
-			for (j=samples-1; j>=0; j--)
+		for (i = 0; i < QSOUND_CHANNELS; i++, pC++)
+		{
+			if (pC->key)
 			{
-				count=(pC->offset)>>16;
-				pC->offset &= 0xffff;
-				if (count)
-				{
-					pC->address += count;
-					if (pC->address >= pC->end)
-					{
-						if (!pC->loop)
-						{
-							/* Reached the end of a non-looped sample */
-							pC->key=0;
-							break;
-						}
-						/* Reached the end, restart the loop */
-						pC->address = (pC->end - pC->loop) & 0xffff;
-					}
-					pC->lastdt=chip->sample_rom[(pC->bank+pC->address)%(chip->sample_rom_length)];
-				}
-
-				(*pOutL) += ((pC->lastdt * lvol) >> 6);
-				(*pOutR) += ((pC->lastdt * rvol) >> 6);
-				pOutL++;
-				pOutR++;
-				pC->offset += pC->pitch;
+				int rvol = (pC->rvol * pC->vol) >> 8;
+				int lvol = (pC->lvol * pC->vol) >> 8;
+				int rendered = qsound_render_voice(chip, pC, chip->voice, count);
+
+				qsound_mix_voice(datap[0] + block, datap[1] + block, chip->voice, rendered, lvol, rvol);
 			}
 		}
-		pC++;
 	}
 
 	if (chip->fpRawDataL)
@@ -8,6 +8,12 @@
 #include "streams.h"
 #include "ym2151.h"
 
+#if (defined(__SSE2__) && defined(PTR64))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 /* undef this to not use MAME timer system */
 #define USE_MAME_TIMERS
@@ -482,6 +488,16 @@ static signed int chanout[8];
 static signed int m2,c1,c2; /* Phase Modulation input for operators 2,3,4 */
 static signed int mem;		/* one sample delay memory */
 
+/* per-block state: the update renders one channel at a time across a block of samples */
+#define YM2151_BLOCK	128
+int ym2151_block_render = 1;
+static UINT32 blk_eg_cnt[YM2151_BLOCK];		/* eg_cnt before the envelope ticks of each sample */
+static UINT32 blk_eg_ticks[YM2151_BLOCK];	/* number of envelope ticks in each sample */
+static UINT32 blk_lfa[YM2151_BLOCK];		/* LFO AM seen by the operators */
+static INT32 blk_lfp[YM2151_BLOCK];			/* LFO PM seen by the phase generator */
+static UINT32 blk_noise_rng[YM2151_BLOCK];	/* noise register seen by channel 7 */
+static signed int blk_chanout[8][YM2151_BLOCK];
+
 
 /* save output as raw 16-bit sample */
 /* #define SAVE_SAMPLE */
@@ -1999,83 +2015,89 @@ rate 11 1         |
                                  --
 */
 
-INLINE void advance_eg(void)
+/* one envelope generator step for a single operator */
+INLINE void advance_eg_op(YM2151Operator *op)
 {
-	YM2151Operator *op;
-	unsigned int i;
+	switch(op->state)
+	{
+	case EG_ATT:	/* attack phase */
+		if ( !(PSG->eg_cnt & ((1<<op->eg_sh_ar)-1) ) )
+		{
+			op->volume += (~op->volume *
+                                   (eg_inc[op->eg_sel_ar + ((PSG->eg_cnt>>op->eg_sh_ar)&7)])
+                                  ) >>4;
 
+			if (op->volume <= MIN_ATT_INDEX)
+			{
+				op->volume = MIN_ATT_INDEX;
+				op->state = EG_DEC;
+			}
 
+		}
+	break;
 
-	PSG->eg_timer += PSG->eg_timer_add;
+	case EG_DEC:	/* decay phase */
+		if ( !(PSG->eg_cnt & ((1<<op->eg_sh_d1r)-1) ) )
+		{
+			op->volume += eg_inc[op->eg_sel_d1r + ((PSG->eg_cnt>>op->eg_sh_d1r)&7)];
 
-	while (PSG->eg_timer >= PSG->eg_timer_overflow)
-	{
-		PSG->eg_timer -= PSG->eg_timer_overflow;
+			if ( op->volume >= op->d1l )
+				op->state = EG_SUS;
 
-		PSG->eg_cnt++;
+		}
+	break;
 
-		/* envelope generator */
-		op = &PSG->oper[0];	/* CH 0 M1 */
-		i = 32;
-		do
+	case EG_SUS:	/* sustain phase */
+		if ( !(PSG->eg_cnt & ((1<<op->eg_sh_d2r)-1) ) )
 		{
-			switch(op->state)
+			op->volume += eg_inc[op->eg_sel_d2r + ((PSG->eg_cnt>>op->eg_sh_d2r)&7)];
+
+			if ( op->volume >= MAX_ATT_INDEX )
 			{
-			case EG_ATT:	/* attack phase */
-				if ( !(PSG->eg_cnt & ((1<<op->eg_sh_ar)-1) ) )
-				{
-					op->volume += (~op->volume *
-                                   (eg_inc[op->eg_sel_ar + ((PSG->eg_cnt>>op->eg_sh_ar)&7)])
-                                  ) >>4;
+				op->volume = MAX_ATT_INDEX;
+				op->state = EG_OFF;
+			}
 
-					if (op->volume <= MIN_ATT_INDEX)
-					{
-						op->volume = MIN_ATT_INDEX;
-						op->state = EG_DEC;
-					}
+		}
+	break;
 
-				}
-			break;
+	case EG_REL:	/* release phase */
+		if ( !(PSG->eg_cnt & ((1<<op->eg_sh_rr)-1) ) )
+		{
+			op->volume += eg_inc[op->eg_sel_rr + ((PSG->eg_cnt>>op->eg_sh_rr)&7)];
 
-			case EG_DEC:	/* decay phase */
-				if ( !(PSG->eg_cnt & ((1<<op->eg_sh_d1r)-1) ) )
-				{
-					op->volume += eg_inc[op->eg_sel_d1r + ((PSG->eg_cnt>>op->eg_sh_d1r)&7)];
+			if ( op->volume >= MAX_ATT_INDEX )
+			{
+				op->volume = MAX_ATT_INDEX;
+				op->state = EG_OFF;
+			}
 
-					if ( op->volume >= op->d1l )
-						op->state = EG_SUS;
+		}
+	break;
+	}
+}
 
-				}
-			break;
+INLINE void advance_eg(void)
+{
+	YM2151Operator *op;
+	unsigned int i;
 
-			case EG_SUS:	/* sustain phase */
-				if ( !(PSG->eg_cnt & ((1<<op->eg_sh_d2r)-1) ) )
-				{
-					op->volume += eg_inc[op->eg_sel_d2r + ((PSG->eg_cnt>>op->eg_sh_d2r)&7)];
 
-					if ( op->volume >= MAX_ATT_INDEX )
-					{
-						op->volume = MAX_ATT_INDEX;
-						op->state = EG_OFF;
-					}
 
-				}
-			break;
+	PSG->eg_timer += PSG->eg_timer_add;
 
-			case EG_REL:	/* release phase */
-				if ( !(PSG->eg_cnt & ((1<<op->eg_sh_rr)-1) ) )
-				{
-					op->volume += eg_inc[op->eg_sel_rr + ((PSG->eg_cnt>>op->eg_sh_rr)&7)];
+	while (PSG->eg_timer >= PSG->eg_timer_overflow)
+	{
+		PSG->eg_timer -= PSG->eg_timer_overflow;
 
-					if ( op->volume >= MAX_ATT_INDEX )
-					{
-						op->volume = MAX_ATT_INDEX;
-						op->state = EG_OFF;
-					}
+		PSG->eg_cnt++;
 
-				}
-			break;
-			}
+		/* envelope generator */
+		op = &PSG->oper[0];	/* CH 0 M1 */
+		i = 32;
+		do
+		{
+			advance_eg_op(op);
 			op++;
 			i--;
 		}while (i);
@@ -2083,9 +2105,9 @@ INLINE void advance_eg(void)
 }
 
 
-INLINE void advance(void)
+/* LFO waveform and noise generator step */
+INLINE void advance_lfo_noise(void)
 {
-	YM2151Operator *op;
 	unsigned int i;
 	int a,p;
 
@@ -2181,49 +2203,48 @@ INLINE void advance(void)
 		PSG->noise_rng = (j<<16) | (PSG->noise_rng>>1);
 		i--;
 	}
+}
 
-
-	/* phase generator */
-	op = &PSG->oper[0];	/* CH 0 M1 */
-	i = 8;
-	do
+/* phase generator step for the four operators of one channel */
+INLINE void advance_phase(YM2151Operator *op)
+{
+	if (op->pms)	/* only when phase modulation from LFO is enabled for this channel */
 	{
-		if (op->pms)	/* only when phase modulation from LFO is enabled for this channel */
-		{
-			INT32 mod_ind = PSG->lfp;		/* -128..+127 (8bits signed) */
-			if (op->pms < 6)
-				mod_ind >>= (6 - op->pms);
-			else
-				mod_ind <<= (op->pms - 5);
+		INT32 mod_ind = PSG->lfp;		/* -128..+127 (8bits signed) */
+		if (op->pms < 6)
+			mod_ind >>= (6 - op->pms);
+		else
+			mod_ind <<= (op->pms - 5);
 
-			if (mod_ind)
-			{
-				UINT32 kc_channel =	op->kc_i + mod_ind;
-				(op+0)->phase += ( (PSG->freq[ kc_channel + (op+0)->dt2 ] + (op+0)->dt1) * (op+0)->mul ) >> 1;
-				(op+1)->phase += ( (PSG->freq[ kc_channel + (op+1)->dt2 ] + (op+1)->dt1) * (op+1)->mul ) >> 1;
-				(op+2)->phase += ( (PSG->freq[ kc_channel + (op+2)->dt2 ] + (op+2)->dt1) * (op+2)->mul ) >> 1;
-				(op+3)->phase += ( (PSG->freq[ kc_channel + (op+3)->dt2 ] + (op+3)->dt1) * (op+3)->mul ) >> 1;
-			}
-			else		/* phase modulation from LFO is equal to zero */
-			{
-				(op+0)->phase += (op+0)->freq;
-				(op+1)->phase += (op+1)->freq;
-				(op+2)->phase += (op+2)->freq;
-				(op+3)->phase += (op+3)->freq;
-			}
+		if (mod_ind)
+		{
+			UINT32 kc_channel =	op->kc_i + mod_ind;
+			(op+0)->phase += ( (PSG->freq[ kc_channel + (op+0)->dt2 ] + (op+0)->dt1) * (op+0)->mul ) >> 1;
+			(op+1)->phase += ( (PSG->freq[ kc_channel + (op+1)->dt2 ] + (op+1)->dt1) * (op+1)->mul ) >> 1;
+			(op+2)->phase += ( (PSG->freq[ kc_channel + (op+2)->dt2 ] + (op+2)->dt1) * (op+2)->mul ) >> 1;
+			(op+3)->phase += ( (PSG->freq[ kc_channel + (op+3)->dt2 ] + (op+3)->dt1) * (op+3)->mul ) >> 1;
 		}
-		else			/* phase modulation from LFO is disabled */
+		else		/* phase modulation from LFO is equal to zero */
 		{
 			(op+0)->phase += (op+0)->freq;
 			(op+1)->phase += (op+1)->freq;
 			(op+2)->phase += (op+2)->freq;
 			(op+3)->phase += (op+3)->freq;
 		}
+	}
+	else			/* phase modulation from LFO is disabled */
+	{
+		(op+0)->phase += (op+0)->freq;
+		(op+1)->phase += (op+1)->freq;
+		(op+2)->phase += (op+2)->freq;
+		(op+3)->phase += (op+3)->freq;
+	}
+}
 
-		op+=4;
-		i--;
-	}while (i);
-
+INLINE void advance_csm(void)
+{
+	YM2151Operator *op;
+	unsigned int i;
 
 	/* CSM is calculated *after* the phase generator calculations (verified on real chip)
     * CSM keyon line seems to be ORed with the KO line inside of the chip.
@@ -2263,6 +2284,186 @@ INLINE void advance(void)
 	}
 }
 
+/* one sample step of the LFO, noise, phase generators and CSM, for ym2151_update_one's
+   sample-by-sample loop */
+INLINE void advance(void)
+{
+	unsigned int i;
+
+	advance_lfo_noise();
+	for (i=0; i<8; i++)
+		advance_phase(&PSG->oper[i*4]);
+	advance_csm();
+}
+
+/* advance the global generators over a block, recording what each sample sees */
+static void prepare_block(int length)
+{
+	int i;
+
+	for (i=0; i<length; i++)
+	{
+		UINT32 ticks = 0;
+
+		blk_eg_cnt[i] = PSG->eg_cnt;
+		PSG->eg_timer += PSG->eg_timer_add;
+		while (PSG->eg_timer >= PSG->eg_timer_overflow)
+		{
+			PSG->eg_timer -= PSG->eg_timer_overflow;
+			PSG->eg_cnt++;
+			ticks++;
+		}
+		blk_eg_ticks[i] = ticks;
+		blk_lfa[i] = PSG->lfa;
+		blk_noise_rng[i] = PSG->noise_rng;
+
+		advance_lfo_noise();
+		blk_lfp[i] = PSG->lfp;
+	}
+}
+
+/* a channel whose slots are all off and whose feedback/delay taps are empty outputs silence */
+INLINE int channel_is_idle(YM2151Operator *op)
+{
+	int i;
+
+	if (op->fb_out_prev | op->fb_out_curr | op->mem_value)
+		return 0;
+	for (i=0; i<4; i++)
+		if (op[i].state != EG_OFF || op[i].volume < MAX_ATT_INDEX)
+			return 0;
+	return 1;
+}
+
+/* render one channel over a block prepared by prepare_block() */
+static void render_channel(unsigned int chan, signed int *dest, int length)
+{
+	YM2151Operator *op = &PSG->oper[chan*4];
+	UINT32 eg_cnt = PSG->eg_cnt;
+	UINT32 lfa = PSG->lfa;
+	INT32 lfp = PSG->lfp;
+	UINT32 noise_rng = PSG->noise_rng;
+	int i;
+
+	if (channel_is_idle(op))
+	{
+		memset(dest, 0, length * sizeof(*dest));
+		if (op->pms)
+		{
+			for (i=0; i<length; i++)
+			{
+				PSG->lfp = blk_lfp[i];
+				advance_phase(op);
+			}
+		}
+		else
+		{
+			op[0].phase += op[0].freq * length;
+			op[1].phase += op[1].freq * length;
+			op[2].phase += op[2].freq * length;
+			op[3].phase += op[3].freq * length;
+		}
+		PSG->lfp = lfp;
+		return;
+	}
+
+	for (i=0; i<length; i++)
+	{
+		UINT32 t;
+
+		for (t=0; t<blk_eg_ticks[i]; t++)
+		{
+			PSG->eg_cnt = blk_eg_cnt[i] + t + 1;
+			advance_eg_op(op+0);
+			advance_eg_op(op+1);
+			advance_eg_op(op+2);
+			advance_eg_op(op+3);
+		}
+
+		PSG->lfa = blk_lfa[i];
+		chanout[chan] = 0;
+		if (chan == 7)
+		{
+			PSG->noise_rng = blk_noise_rng[i];
+			chan7_calc();
+		}
+		else
+			chan_calc(chan);
+		dest[i] = chanout[chan];
+
+		PSG->lfp = blk_lfp[i];
+		advance_phase(op);
+	}
+
+	/* leave the generators where prepare_block() put them */
+	PSG->eg_cnt = eg_cnt;
+	PSG->lfa = lfa;
+	PSG->lfp = lfp;
+	PSG->noise_rng = noise_rng;
+}
+
+/* pan, sum and clip the eight channel buffers of a block */
+static void mix_block(SAMP *bufL, SAMP *bufR, int length)
+{
+	int i = 0, c;
+
+#if (SAMPLE_BITS==16)
+#if (defined(__SSE2__) && defined(PTR64))
+	for ( ; i + 4 <= length; i += 4)
+	{
+		__m128i l = _mm_setzero_si128();
+		__m128i r = _mm_setzero_si128();
+		__m128i p;
+
+		for (c=0; c<8; c++)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i *)&blk_chanout[c][i]);
+			l = _mm_add_epi32(l, _mm_and_si128(v, _mm_set1_epi32(PSG->pan[c*2])));
+			r = _mm_add_epi32(r, _mm_and_si128(v, _mm_set1_epi32(PSG->pan[c*2+1])));
+		}
+		p = _mm_packs_epi32(l, r);
+		_mm_storeu_si128((__m128i *)&bufL[i], _mm_srai_epi32(_mm_unpacklo_epi16(p, p), 16));
+		_mm_storeu_si128((__m128i *)&bufR[i], _mm_srai_epi32(_mm_unpackhi_epi16(p, p), 16));
+	}
+#elif defined(__ARM_NEON__)
+	for ( ; i + 4 <= length; i += 4)
+	{
+		int32x4_t l = vdupq_n_s32(0);
+		int32x4_t r = vdupq_n_s32(0);
+
+		for (c=0; c<8; c++)
+		{
+			int32x4_t v = vld1q_s32(&blk_chanout[c][i]);
+			l = vaddq_s32(l, vandq_s32(v, vdupq_n_s32(PSG->pan[c*2])));
+			r = vaddq_s32(r, vandq_s32(v, vdupq_n_s32(PSG->pan[c*2+1])));
+		}
+		vst1q_s32(&bufL[i], vmovl_s16(vqmovn_s32(l)));
+		vst1q_s32(&bufR[i], vmovl_s16(vqmovn_s32(r)));
+	}
+#endif
+#endif
+
+	for ( ; i < length; i++)
+	{
+		signed int outl = 0, outr = 0;
+
+		for (c=0; c<8; c++)
+		{
+			outl += (blk_chanout[c][i] & PSG->pan[c*2]);
+			outr += (blk_chanout[c][i] & PSG->pan[c*2+1]);
+		}
+
+		outl >>= FINAL_SH;
+		outr >>= FINAL_SH;
+		if (outl > MAXOUT) outl = MAXOUT;
+			else if (outl < MINOUT) outl = MINOUT;
+		if (outr > MAXOUT) outr = MAXOUT;
+			else if (outr < MINOUT) outr = MINOUT;
+		bufL[i] = (SAMP)outl;
+		bufR[i] = (SAMP)outr;
+	}
+}
+
 #if 0
 INLINE signed int acc_calc(signed int value)
 {
@@ -2367,8 +2568,6 @@ INLINE signed int acc_calc(signed int value)
 */
 void ym2151_update_one(void *chip, SAMP **buffers, int length)
 {
-	int i;
-	signed int outl,outr;
 	SAMP *bufL, *bufR;
 
 	bufL = buffers[0];
@@ -2395,86 +2594,156 @@ void ym2151_update_one(void *chip, SAMP **buffers, int length)
 	}
 #endif
 
-	for (i=0; i<length; i++)
+	if (ym2151_block_render)
 	{
-		advance_eg();
-
-		chanout[0] = 0;
-		chanout[1] = 0;
-		chanout[2] = 0;
-		chanout[3] = 0;
-		chanout[4] = 0;
-		chanout[5] = 0;
-		chanout[6] = 0;
-		chanout[7] = 0;
-
-		chan_calc(0);
-		SAVE_SINGLE_CHANNEL(0)
-		chan_calc(1);
-		SAVE_SINGLE_CHANNEL(1)
-		chan_calc(2);
-		SAVE_SINGLE_CHANNEL(2)
-		chan_calc(3);
-		SAVE_SINGLE_CHANNEL(3)
-		chan_calc(4);
-		SAVE_SINGLE_CHANNEL(4)
-		chan_calc(5);
-		SAVE_SINGLE_CHANNEL(5)
-		chan_calc(6);
-		SAVE_SINGLE_CHANNEL(6)
-		chan7_calc();
-		SAVE_SINGLE_CHANNEL(7)
-
-		outl = chanout[0] & PSG->pan[0];
-		outr = chanout[0] & PSG->pan[1];
-		outl += (chanout[1] & PSG->pan[2]);
-		outr += (chanout[1] & PSG->pan[3]);
-		outl += (chanout[2] & PSG->pan[4]);
-		outr += (chanout[2] & PSG->pan[5]);
-		outl += (chanout[3] & PSG->pan[6]);
-		outr += (chanout[3] & PSG->pan[7]);
-		outl += (chanout[4] & PSG->pan[8]);
-		outr += (chanout[4] & PSG->pan[9]);
-		outl += (chanout[5] & PSG->pan[10]);
-		outr += (chanout[5] & PSG->pan[11]);
-		outl += (chanout[6] & PSG->pan[12]);
-		outr += (chanout[6] & PSG->pan[13]);
-		outl += (chanout[7] & PSG->pan[14]);
-		outr += (chanout[7] & PSG->pan[15]);
+		while (length > 0)
+		{
+			/* a pending CSM key on/off hits every slot between two samples */
+			int count = PSG->csm_req ? 1 : MIN(length, YM2151_BLOCK);
+			int i;
 
-		outl >>= FINAL_SH;
-		outr >>= FINAL_SH;
-		if (outl > MAXOUT) outl = MAXOUT;
-			else if (outl < MINOUT) outl = MINOUT;
-		if (outr > MAXOUT) outr = MAXOUT;
-			else if (outr < MINOUT) outr = MINOUT;
-		((SAMP*)bufL)[i] = (SAMP)outl;
-		((SAMP*)bufR)[i] = (SAMP)outr;
+			prepare_block(count);
+			for (i=0; i<8; i++)
+				render_channel(i, blk_chanout[i], count);
+			mix_block(bufL, bufR, count);
 
-		SAVE_ALL_CHANNELS
+#ifdef SAVE_SEPARATE_CHANNELS
+			for (i=0; i<count; i++)
+			{
+				int j;
+				for (j=0; j<8; j++)
+				{
+					chanout[j] = blk_chanout[j][i];
+					SAVE_SINGLE_CHANNEL(j)
+				}
+			}
+#endif
+#ifdef SAVE_SAMPLE
+			for (i=0; i<count; i++)
+			{
+				signed int outl = bufL[i], outr = bufR[i];
+				SAVE_ALL_CHANNELS
+			}
+#endif
 
 #ifdef USE_MAME_TIMERS
-		/* ASG 980324 - handled by real timers now */
+			/* ASG 980324 - handled by real timers now */
 #else
-		/* calculate timer A */
-		if (PSG->tim_A)
-		{
-			PSG->tim_A_val -= ( 1 << TIMER_SH );
-			if (PSG->tim_A_val <= 0)
+			/* timer A; a CSM request lands at the end of the block */
+			for (i=0; i<count; i++)
 			{
-				PSG->tim_A_val += PSG->tim_A_tab[ PSG->timer_A_index ];
-				if (PSG->irq_enable & 0x04)
+				/* calculate timer A */
+				if (PSG->tim_A)
 				{
-					int oldstate = PSG->status & 3;
-					PSG->status |= 1;
-					if ((!oldstate) && (PSG->irqhandler)) (*PSG->irqhandler)(chip->device, 1);
+					PSG->tim_A_val -= ( 1 << TIMER_SH );
+					if (PSG->tim_A_val <= 0)
+					{
+						PSG->tim_A_val += PSG->tim_A_tab[ PSG->timer_A_index ];
+						if (PSG->irq_enable & 0x04)
+						{
+							int oldstate = PSG->status & 3;
+							PSG->status |= 1;
+							if ((!oldstate) && (PSG->irqhandler)) (*PSG->irqhandler)(chip->device, 1);
+						}
+						if (PSG->irq_enable & 0x80)
+							PSG->csm_req = 2;	/* request KEY ON / KEY OFF sequence */
+					}
 				}
-				if (PSG->irq_enable & 0x80)
-					PSG->csm_req = 2;	/* request KEY ON / KEY OFF sequence */
 			}
+#endif
+			advance_csm();
+
+			bufL += count;
+			bufR += count;
+			length -= count;
 		}
+	}
+	else
+	{
+		int i;
+		signed int outl,outr;
+
+		for (i=0; i<length; i++)
+		{
+			advance_eg();
+
+			chanout[0] = 0;
+			chanout[1] = 0;
+			chanout[2] = 0;
+			chanout[3] = 0;
+			chanout[4] = 0;
+			chanout[5] = 0;
+			chanout[6] = 0;
+			chanout[7] = 0;
+
+			chan_calc(0);
+			SAVE_SINGLE_CHANNEL(0)
+			chan_calc(1);
+			SAVE_SINGLE_CHANNEL(1)
+			chan_calc(2);
+			SAVE_SINGLE_CHANNEL(2)
+			chan_calc(3);
+			SAVE_SINGLE_CHANNEL(3)
+			chan_calc(4);
+			SAVE_SINGLE_CHANNEL(4)
+			chan_calc(5);
+			SAVE_SINGLE_CHANNEL(5)
+			chan_calc(6);
+			SAVE_SINGLE_CHANNEL(6)
+			chan7_calc();
+			SAVE_SINGLE_CHANNEL(7)
+
+			outl = chanout[0] & PSG->pan[0];
+			outr = chanout[0] & PSG->pan[1];
+			outl += (chanout[1] & PSG->pan[2]);
+			outr += (chanout[1] & PSG->pan[3]);
+			outl += (chanout[2] & PSG->pan[4]);
+			outr += (chanout[2] & PSG->pan[5]);
+			outl += (chanout[3] & PSG->pan[6]);
+			outr += (chanout[3] & PSG->pan[7]);
+			outl += (chanout[4] & PSG->pan[8]);
+			outr += (chanout[4] & PSG->pan[9]);
+			outl += (chanout[5] & PSG->pan[10]);
+			outr += (chanout[5] & PSG->pan[11]);
+			outl += (chanout[6] & PSG->pan[12]);
+			outr += (chanout[6] & PSG->pan[13]);
+			outl += (chanout[7] & PSG->pan[14]);
+			outr += (chanout[7] & PSG->pan[15]);
+
+			outl >>= FINAL_SH;
+			outr >>= FINAL_SH;
+			if (outl > MAXOUT) outl = MAXOUT;
+				else if (outl < MINOUT) outl = MINOUT;
+			if (outr > MAXOUT) outr = MAXOUT;
+				else if (outr < MINOUT) outr = MINOUT;
+			((SAMP*)bufL)[i] = (SAMP)outl;
+			((SAMP*)bufR)[i] = (SAMP)outr;
+
+			SAVE_ALL_CHANNELS
+
+#ifdef USE_MAME_TIMERS
+			/* ASG 980324 - handled by real timers now */
+#else
+			/* calculate timer A */
+			if (PSG->tim_A)
+			{
+				PSG->tim_A_val -= ( 1 << TIMER_SH );
+				if (PSG->tim_A_val <= 0)
+				{
+					PSG->tim_A_val += PSG->tim_A_tab[ PSG->timer_A_index ];
+					if (PSG->irq_enable & 0x04)
+					{
+						int oldstate = PSG->status & 3;
+						PSG->status |= 1;
+						if ((!oldstate) && (PSG->irqhandler)) (*PSG->irqhandler)(chip->device, 1);
+					}
+					if (PSG->irq_enable & 0x80)
+						PSG->csm_req = 2;	/* request KEY ON / KEY OFF sequence */
+				}
+			}
 #endif
-		advance();
+			advance();
+		}
 	}
 }
 
@@ -71,6 +71,10 @@ void ym2151_reset_chip(void *chip);
 */
 void ym2151_update_one(void *chip, SAMP **buffers, int length);
 
+/* render a channel at a time over blocks of samples (default) or all channels
+   sample by sample like the original loop; both give the same output */
+extern int ym2151_block_render;
+
 /* write 'v' to register 'r' on YM2151 chip number 'n'*/
 void ym2151_write_reg(void *chip, int r, int v);
 
@@ -41,11 +41,38 @@
     These sample buffers can then be further resampled and passed to
     other streams, or output as desired.
 
+    Register writes that only change what a chip will generate can be
+    queued in the stream's journal instead of forcing an update each
+    time. Each write is stamped with the sample it arrived at, and the
+    journal is played back the next time the stream is updated: the
+    stream generates up to the sample of each write, applies it, and
+    carries on, so the output is the same as updating on every write
+    while the callback runs once per update instead of once per write.
+    Setting JOURNAL_CHUNK_SAMPLES above 1 rounds each write up to a chunk
+    of that many samples, trading accuracy (writes land up to that many
+    samples late) for fewer, larger generation passes.
+    Anything that needs the chip's current state (a status read, a write
+    with side effects outside the chip) simply updates the stream first.
+
+    A stream with no inputs can declare itself idle from its callback once
+    the chip has gone quiet (no voices playing, envelopes all off). From
+    then on the callback is skipped and the outputs are filled with
+    silence; streams reading from it skip resampling once they are past
+    the point where the silence began. The chip wakes the stream when a
+    write could start it up again, and is told how many samples were
+    skipped so it can catch up any free-running counters.
+
 ***************************************************************************/
 
 #include "emu.h"
 #include "streams.h"
 
+#if (defined(__SSE2__) && defined(PTR64))
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 
 
 /***************************************************************************
@@ -54,10 +81,18 @@
 
 #define OUTPUT_BUFFER_UPDATES		(5)
 
+#define JOURNAL_ENTRIES				(256)
+#define JOURNAL_CHUNK_SAMPLES		(1)		/* power of two; above 1 delays writes, see above */
+
 #define FRAC_BITS			22
 #define FRAC_ONE			(1 << FRAC_BITS)
 #define FRAC_MASK			(FRAC_ONE - 1)
 
+#define FIR_PHASE_BITS		8
+#define FIR_PHASES			(1 << FIR_PHASE_BITS)
+#define FIR_BASE_TAPS		16
+#define FIR_MAX_TAPS		64
+
 
 
 /***************************************************************************
@@ -66,6 +101,7 @@
 
 typedef struct _stream_input stream_input;
 typedef struct _stream_output stream_output;
+typedef struct _stream_journal_entry stream_journal_entry;
 
 struct _stream_input
 {
@@ -81,6 +117,13 @@ struct _stream_input
 	/* resampling information */
 	attoseconds_t		latency_attoseconds;	/* latency between this stream and the input stream */
 	INT16			gain;			/* gain to apply to this input */
+	UINT8			resampler;		/* STREAM_RESAMPLER_* used for this input */
+	UINT32			step;			/* source samples per output sample, in FRAC_BITS fixed point */
+	attoseconds_t		frac_attoseconds;	/* attoseconds per 1/FRAC_ONE of a source sample */
+
+	/* polyphase filter */
+	float			*fir;			/* FIR_PHASES sets of fir_taps coefficients */
+	int			fir_taps;		/* taps per phase, a multiple of 4 */
 };
 
 
@@ -98,6 +141,15 @@ struct _stream_output
 };
 
 
+struct _stream_journal_entry
+{
+	INT32			sampindex;		/* sample at which the write arrived */
+	stream_journal_func	func;			/* function that applies the write */
+	offs_t			offset;			/* register offset */
+	UINT8			data;			/* register data */
+};
+
+
 class sound_stream
 {
 public:
@@ -136,6 +188,16 @@ public:
 	/* callback information */
 	stream_update_func	callback;			/* callback function */
 	void			*param;				/* callback function parameter */
+
+	/* register write journal */
+	stream_journal_entry	*journal;			/* queued register writes */
+	int			journal_entries;		/* number of queued writes */
+	int			journal_replay;			/* TRUE while the journal is being played back */
+
+	/* idle tracking */
+	int			idle;				/* TRUE while the callback is being skipped */
+	UINT32			idle_samples;			/* samples skipped since the stream went idle */
+	INT32			silent_sampindex;		/* first output sample of the idle silence */
 };
 
 
@@ -149,16 +211,30 @@ struct _streams_private
 };
 
 
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+/* resampler requested by the OSD layer; latched per input when its rates are computed */
+extern int stream_resampler;
+
+
+
 /***************************************************************************
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
+static STATE_PRESAVE( stream_presave );
 static STATE_POSTLOAD( stream_postload );
 static void allocate_resample_buffers(running_machine *machine, sound_stream *stream);
 static void allocate_output_buffers(running_machine *machine, sound_stream *stream);
 static void recompute_sample_rate_data(running_machine *machine, sound_stream *stream);
+static void build_polyphase_filter(running_machine *machine, stream_input *input, UINT32 source_rate, UINT32 dest_rate);
 static void generate_samples(sound_stream *stream, int samples);
+static void replay_journal(sound_stream *stream, INT32 update_sampindex);
 static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 numsamples);
+static void resample_linear(stream_sample_t *dest, const stream_sample_t *source, UINT32 basefrac, UINT32 step, INT32 gain, UINT32 numsamples);
+static void resample_polyphase(stream_sample_t *dest, const stream_sample_t *source, UINT32 basefrac, UINT32 step, INT32 gain, UINT32 numsamples, const float *fir, int taps);
 
 
 /***************************************************************************
@@ -217,6 +293,7 @@ void streams_init(running_machine *machine)
 	/* register global states */
 	state_save_register_global(machine, strdata->last_update.seconds);
 	state_save_register_global(machine, strdata->last_update.attoseconds);
+	state_save_register_presave(machine, stream_presave, strdata);
 	state_save_register_postload(machine, stream_postload, strdata);
 }
 
@@ -255,6 +332,7 @@ void streams_update(running_machine *machine)
 		{
 			stream->output_sampindex -= stream->sample_rate;
 			stream->output_base_sampindex -= stream->sample_rate;
+			stream->silent_sampindex = MAX(stream->silent_sampindex - (INT32)stream->sample_rate, stream->output_base_sampindex);
 		}
 
 		/* note our current output sample */
@@ -297,8 +375,15 @@ void streams_update(running_machine *machine)
 			stream->sample_rate = stream->new_sample_rate;
 			stream->new_sample_rate = 0;
 
-			/* recompute all the data */
+			/* recompute all the data, including the streams that take us as input */
 			recompute_sample_rate_data(machine, stream);
+			for (sound_stream *dependent = strdata->stream_head; dependent != NULL; dependent = dependent->next)
+				for (int inputnum = 0; inputnum < dependent->inputs; inputnum++)
+					if (dependent->input[inputnum].source != NULL && dependent->input[inputnum].source->owner == stream)
+					{
+						recompute_sample_rate_data(machine, dependent);
+						break;
+					}
 
 			/* reset our sample indexes to the current time */
 			stream->output_sampindex = (INT64)stream->output_sampindex * (INT64)stream->sample_rate / old_rate;
@@ -308,6 +393,7 @@ void streams_update(running_machine *machine)
 			/* clear out the buffer */
 			for (outputnum = 0; outputnum < stream->outputs; outputnum++)
 				memset(stream->output[outputnum].buffer, 0, stream->max_samples_per_update * sizeof(stream->output[outputnum].buffer[0]));
+			stream->silent_sampindex = stream->output_base_sampindex;
 		}
 	}
 }
@@ -493,7 +579,17 @@ void stream_update(sound_stream *stream)
 {
 	running_machine *machine = stream->device->machine;
 	streams_private *strdata = machine->streams_data;
-	INT32 update_sampindex = time_to_sampindex(strdata, stream, timer_get_time(machine));
+	INT32 update_sampindex;
+
+	/* a write being played back from the journal is already in position */
+	if (stream->journal_replay)
+		return;
+
+	update_sampindex = time_to_sampindex(strdata, stream, timer_get_time(machine));
+
+	/* play back any queued writes first */
+	if (stream->journal_entries > 0)
+		replay_journal(stream, update_sampindex);
 
 	/* generate samples to get us up to the appropriate time */
 	assert(stream->output_sampindex - stream->output_base_sampindex >= 0);
@@ -505,6 +601,72 @@ void stream_update(sound_stream *stream)
 }
 
 
+/*-------------------------------------------------
+    stream_journal_write - queue a register write
+    that is applied when the stream next generates
+    samples
+-------------------------------------------------*/
+
+void stream_journal_write(sound_stream *stream, stream_journal_func func, offs_t offset, UINT8 data)
+{
+	running_machine *machine = stream->device->machine;
+	stream_journal_entry *entry;
+
+	/* allocate the journal on first use */
+	if (stream->journal == NULL)
+		stream->journal = auto_alloc_array(machine, stream_journal_entry, JOURNAL_ENTRIES);
+
+	/* if the journal is full, play it back now */
+	if (stream->journal_entries == JOURNAL_ENTRIES)
+		stream_update(stream);
+
+	/* stamp the write with the current sample */
+	entry = &stream->journal[stream->journal_entries++];
+	entry->sampindex = time_to_sampindex(machine->streams_data, stream, timer_get_time(machine));
+	entry->func = func;
+	entry->offset = offset;
+	entry->data = data;
+}
+
+
+/*-------------------------------------------------
+    stream_set_idle - stop calling a stream's
+    callback; its outputs are silent until it is
+    woken
+-------------------------------------------------*/
+
+void stream_set_idle(sound_stream *stream)
+{
+	/* a stream with inputs can't know they are silent too */
+	if (stream->inputs == 0 && !stream->idle)
+	{
+		stream->idle = TRUE;
+		stream->idle_samples = 0;
+	}
+}
+
+
+/*-------------------------------------------------
+    stream_wake - bring an idle stream up to date
+    and resume calling its callback; returns the
+    number of samples skipped while it was idle
+-------------------------------------------------*/
+
+UINT32 stream_wake(sound_stream *stream)
+{
+	UINT32 skipped;
+
+	if (!stream->idle)
+		return 0;
+
+	stream_update(stream);
+	skipped = stream->idle_samples;
+	stream->idle = FALSE;
+	stream->idle_samples = 0;
+	return skipped;
+}
+
+
 /*-------------------------------------------------
     stream_get_output_since_last_update - return a
     pointer to the output buffer and the number of
@@ -674,6 +836,20 @@ void stream_set_output_gain(sound_stream *stream, int output, float gain)
     STREAM BUFFER MAINTENANCE
 ***************************************************************************/
 
+/*-------------------------------------------------
+    stream_presave - save callback; make sure
+    queued writes are in the chip state
+-------------------------------------------------*/
+
+static STATE_PRESAVE( stream_presave )
+{
+	streams_private *strdata = reinterpret_cast<streams_private *>(param);
+	for (sound_stream *stream = strdata->stream_head; stream != NULL; stream = stream->next)
+		if (stream->journal_entries > 0)
+			stream_update(stream);
+}
+
+
 /*-------------------------------------------------
     stream_postload - save/restore callback
 -------------------------------------------------*/
@@ -683,6 +859,13 @@ static STATE_POSTLOAD( stream_postload )
 	streams_private *strdata = reinterpret_cast<streams_private *>(param);
 	for (sound_stream *stream = strdata->stream_head; stream != NULL; stream = stream->next)
 	{
+		/* writes queued before the load no longer apply */
+		stream->journal_entries = 0;
+
+		/* the restored chip state decides whether we are idle */
+		stream->idle = FALSE;
+		stream->idle_samples = 0;
+
 		/* recompute the same rate information */
 		recompute_sample_rate_data(machine, stream);
 
@@ -750,7 +933,8 @@ static void allocate_output_buffers(running_machine *machine, sound_stream *stre
 		for (int outputnum = 0; outputnum < stream->outputs; outputnum++)
 		{
 			stream_output *output = &stream->output[outputnum];
-			stream_sample_t *newbuffer = auto_alloc_array(machine, stream_sample_t, stream->output_bufalloc);
+			/* cleared, since inputs read back past the first generated sample at startup */
+			stream_sample_t *newbuffer = auto_alloc_array_clear(machine, stream_sample_t, stream->output_bufalloc);
 			memcpy(newbuffer, output->buffer, oldsize * sizeof(stream_sample_t));
 			auto_free(machine, output->buffer);
 			output->buffer = newbuffer;
@@ -802,6 +986,25 @@ static void recompute_sample_rate_data(running_machine *machine, sound_stream *s
 			else if (input_stream->sample_rate == stream->sample_rate)
 				latency = 0;
 
+			/* precompute the stepping fraction and the fraction scale */
+			input->step = ((UINT64)input_stream->sample_rate << FRAC_BITS) / stream->sample_rate;
+			input->frac_attoseconds = (new_attosecs_per_sample + FRAC_ONE - 1) >> FRAC_BITS;
+
+			/* pick the resampler; the polyphase filter needs to look half its length ahead,
+			   so fall back to the default one if that would take too much of an update */
+			input->resampler = (input->step == FRAC_ONE) ? STREAM_RESAMPLER_DEFAULT : stream_resampler;
+			if (input->resampler == STREAM_RESAMPLER_POLYPHASE)
+			{
+				attoseconds_t fir_latency;
+
+				build_polyphase_filter(machine, input, input_stream->sample_rate, stream->sample_rate);
+				fir_latency = latency + (input->fir_taps / 2 + 1) * new_attosecs_per_sample;
+				if (fir_latency < strdata->update_attoseconds / 2)
+					latency = fir_latency;
+				else
+					input->resampler = STREAM_RESAMPLER_DEFAULT;
+			}
+
 			/* we generally don't want to tweak the latency, so we just keep the greatest
 			   one we've computed thus far */
 			input->latency_attoseconds = MAX(input->latency_attoseconds, latency);
@@ -811,6 +1014,52 @@ static void recompute_sample_rate_data(running_machine *machine, sound_stream *s
 }
 
 
+/*-------------------------------------------------
+    build_polyphase_filter - compute windowed-sinc
+    coefficients for resampling an input
+-------------------------------------------------*/
+
+static void build_polyphase_filter(running_machine *machine, stream_input *input, UINT32 source_rate, UINT32 dest_rate)
+{
+	/* when decimating, widen the filter so it still spans a few output samples */
+	int ratio = (source_rate + dest_rate - 1) / dest_rate;
+	int taps = MIN(FIR_BASE_TAPS * MAX(ratio, 1), FIR_MAX_TAPS);
+	double cutoff = 0.9 * MIN(1.0, (double)dest_rate / (double)source_rate);
+	int phase, tap;
+
+	/* (re)allocate the coefficient table */
+	if (input->fir_taps != taps)
+	{
+		if (input->fir != NULL)
+			auto_free(machine, input->fir);
+		input->fir = auto_alloc_array(machine, float, FIR_PHASES * taps);
+		input->fir_taps = taps;
+	}
+
+	for (phase = 0; phase < FIR_PHASES; phase++)
+	{
+		float *coef = &input->fir[phase * taps];
+		double frac = (double)phase / FIR_PHASES;
+		double sum = 0;
+
+		/* tap 'n' multiplies source[n - (taps/2 - 1)]; the output sits at frac past source[0] */
+		for (tap = 0; tap < taps; tap++)
+		{
+			double x = (double)(tap - (taps / 2 - 1)) - frac;
+			double w = 0.42 + 0.5 * cos(M_PI * x / (taps / 2)) + 0.08 * cos(2.0 * M_PI * x / (taps / 2));
+			double c = (x == 0) ? cutoff : sin(M_PI * cutoff * x) / (M_PI * x);
+			coef[tap] = c * w;
+			sum += coef[tap];
+		}
+
+		/* normalize for unity gain at DC */
+		for (tap = 0; tap < taps; tap++)
+			coef[tap] /= sum;
+	}
+}
+
+
+
 /***************************************************************************
     SOUND GENERATION
 ***************************************************************************/
@@ -828,6 +1077,15 @@ static void generate_samples(sound_stream *stream, int samples)
 	if (samples <= 0)
 		return;
 
+	/* an idle stream just outputs silence */
+	if (stream->idle)
+	{
+		for (int outputnum = 0; outputnum < stream->outputs; outputnum++)
+			memset(stream->output[outputnum].buffer + (stream->output_sampindex - stream->output_base_sampindex), 0, samples * sizeof(stream->output[outputnum].buffer[0]));
+		stream->idle_samples += samples;
+		return;
+	}
+
 	/* ensure all inputs are up to date and generate resampled data */
 	for (int inputnum = 0; inputnum < stream->inputs; inputnum++)
 	{
@@ -850,6 +1108,46 @@ static void generate_samples(sound_stream *stream, int samples)
 
 	/* run the callback */
 	(*stream->callback)(stream->device, stream->param, stream->input_array, stream->output_array, samples);
+
+	/* if the callback went idle, the silence starts after this block */
+	if (stream->idle)
+		stream->silent_sampindex = stream->output_sampindex + samples;
+}
+
+
+/*-------------------------------------------------
+    replay_journal - apply the queued writes,
+    generating samples up to each one
+-------------------------------------------------*/
+
+static void replay_journal(sound_stream *stream, INT32 update_sampindex)
+{
+	stream->journal_replay = TRUE;
+
+	for (int entrynum = 0; entrynum < stream->journal_entries; entrynum++)
+	{
+		stream_journal_entry *entry = &stream->journal[entrynum];
+
+		/* split the render at the write (or the chunk it rounds up to), but
+		   never past the time we're updating to */
+		INT32 sampindex = entry->sampindex;
+#if (JOURNAL_CHUNK_SAMPLES > 1)
+		sampindex = (sampindex + JOURNAL_CHUNK_SAMPLES - 1) & ~(JOURNAL_CHUNK_SAMPLES - 1);
+#endif
+		if (sampindex > update_sampindex)
+			sampindex = update_sampindex;
+
+		/* generate up to the write and apply it */
+		if (sampindex > stream->output_sampindex)
+		{
+			generate_samples(stream, sampindex - stream->output_sampindex);
+			stream->output_sampindex = sampindex;
+		}
+		(*entry->func)(stream->device, stream->param, entry->offset, entry->data);
+	}
+
+	stream->journal_entries = 0;
+	stream->journal_replay = FALSE;
 }
 
 
@@ -890,17 +1188,25 @@ static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 nums
 	else
 		basesample = -(-basetime / input_stream->attoseconds_per_sample) - 1;
 
+	/* if the source has gone idle before the first sample we need (including the
+	   filter's history), there is nothing to resample */
+	if (input_stream->idle && basesample - input->fir_taps / 2 >= input_stream->silent_sampindex)
+	{
+		memset(dest, 0, numsamples * sizeof(*dest));
+		return input->resample;
+	}
+
 	/* compute a source pointer to the first sample */
 	assert(basesample >= input_stream->output_base_sampindex);
 	source = output->buffer + (basesample - input_stream->output_base_sampindex);
 
 	/* determine the current fraction of a sample */
-	UINT32 basefrac = (basetime - basesample * input_stream->attoseconds_per_sample) / ((input_stream->attoseconds_per_sample + FRAC_ONE - 1) >> FRAC_BITS);
+	UINT32 basefrac = (basetime - basesample * input_stream->attoseconds_per_sample) / input->frac_attoseconds;
 	assert(basefrac >= 0);
 	assert(basefrac < FRAC_ONE);
 
-	/* compute the stepping fraction */
-	UINT32 step = ((UINT64)input_stream->sample_rate << FRAC_BITS) / stream->sample_rate;
+	/* fetch the stepping fraction */
+	UINT32 step = input->step;
 
 	/* if we have equal sample rates, we just need to copy */
 	if (step == FRAC_ONE)
@@ -913,6 +1219,12 @@ static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 nums
 		}
 	}
 
+	/* the optional resamplers */
+	else if (input->resampler == STREAM_RESAMPLER_LINEAR)
+		resample_linear(dest, source, basefrac, step, gain, numsamples);
+	else if (input->resampler == STREAM_RESAMPLER_POLYPHASE)
+		resample_polyphase(dest, source, basefrac, step, gain, numsamples, input->fir, input->fir_taps);
+
 	/* input is undersampled: point sample except where our sample period covers a boundary */
 	else if (step < FRAC_ONE)
 	{
@@ -980,3 +1292,110 @@ static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 nums
 
 	return input->resample;
 }
+
+
+/*-------------------------------------------------
+    resample_linear - linearly interpolate
+    between source samples
+-------------------------------------------------*/
+
+static void resample_linear(stream_sample_t *dest, const stream_sample_t *source, UINT32 basefrac, UINT32 step, INT32 gain, UINT32 numsamples)
+{
+	const float fracscale = 1.0f / FRAC_ONE;
+	const float scale = gain / 256.0f;
+	UINT32 sampnum = 0;
+
+#if (defined(__SSE2__) && defined(PTR64)) || defined(__ARM_NEON__)
+	for ( ; sampnum + 4 <= numsamples; sampnum += 4)
+	{
+		INT32 s0[4], s1[4];
+		float frac[4];
+		int lane;
+
+		/* fetch the sample pairs */
+		for (lane = 0; lane < 4; lane++)
+		{
+			s0[lane] = source[0];
+			s1[lane] = source[1];
+			frac[lane] = basefrac * fracscale;
+			basefrac += step;
+			source += basefrac >> FRAC_BITS;
+			basefrac &= FRAC_MASK;
+		}
+
+		/* blend and apply the gain four at a time */
+#if (defined(__SSE2__) && defined(PTR64))
+		{
+			__m128 a = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)s0));
+			__m128 b = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)s1));
+			__m128 r = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_loadu_ps(frac)));
+			_mm_storeu_si128((__m128i *)&dest[sampnum], _mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(scale))));
+		}
+#else
+		{
+			float32x4_t a = vcvtq_f32_s32(vld1q_s32(s0));
+			float32x4_t b = vcvtq_f32_s32(vld1q_s32(s1));
+			float32x4_t r = vmlaq_f32(a, vsubq_f32(b, a), vld1q_f32(frac));
+			vst1q_s32(&dest[sampnum], vcvtq_s32_f32(vmulq_n_f32(r, scale)));
+		}
+#endif
+	}
+#endif
+
+	for ( ; sampnum < numsamples; sampnum++)
+	{
+		float a = (float)source[0];
+		float r = a + ((float)source[1] - a) * (basefrac * fracscale);
+		dest[sampnum] = (stream_sample_t)(r * scale);
+
+		basefrac += step;
+		source += basefrac >> FRAC_BITS;
+		basefrac &= FRAC_MASK;
+	}
+}
+
+
+/*-------------------------------------------------
+    resample_polyphase - run the source through
+    the input's polyphase FIR
+-------------------------------------------------*/
+
+static void resample_polyphase(stream_sample_t *dest, const stream_sample_t *source, UINT32 basefrac, UINT32 step, INT32 gain, UINT32 numsamples, const float *fir, int taps)
+{
+	const float scale = gain / 256.0f;
+
+	while (numsamples--)
+	{
+		const float *coef = fir + (basefrac >> (FRAC_BITS - FIR_PHASE_BITS)) * taps;
+		const stream_sample_t *src = source - (taps / 2 - 1);
+		float acc;
+		int tap;
+
+#if (defined(__SSE2__) && defined(PTR64))
+		__m128 sum = _mm_setzero_ps();
+		for (tap = 0; tap < taps; tap += 4)
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&src[tap])), _mm_loadu_ps(&coef[tap])));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+		acc = _mm_cvtss_f32(sum);
+#elif defined(__ARM_NEON__)
+		float32x4_t sum = vdupq_n_f32(0);
+		float32x2_t half;
+		for (tap = 0; tap < taps; tap += 4)
+			sum = vmlaq_f32(sum, vcvtq_f32_s32(vld1q_s32(&src[tap])), vld1q_f32(&coef[tap]));
+		half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+		acc = vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+		acc = 0;
+		for (tap = 0; tap < taps; tap++)
+			acc += src[tap] * coef[tap];
+#endif
+
+		*dest++ = (stream_sample_t)(acc * scale);
+
+		/* advance */
+		basefrac += step;
+		source += basefrac >> FRAC_BITS;
+		basefrac &= FRAC_MASK;
+	}
+}
@@ -21,6 +21,11 @@
 #define STREAMS_UPDATE_FREQUENCY	(50)
 #define STREAMS_UPDATE_ATTOTIME		ATTOTIME_IN_HZ(STREAMS_UPDATE_FREQUENCY)
 
+/* resamplers for stream inputs running at a different rate from their stream */
+#define STREAM_RESAMPLER_DEFAULT	(0)		/* point sampling up, energy summing down */
+#define STREAM_RESAMPLER_LINEAR		(1)		/* linear interpolation, SIMD where available */
+#define STREAM_RESAMPLER_POLYPHASE	(2)		/* windowed-sinc polyphase FIR */
+
 
 
 /***************************************************************************
@@ -33,6 +38,10 @@ typedef void (*stream_update_func)(device_t *device, void *param, stream_sample_
 
 #define STREAM_UPDATE(name) void name(device_t *device, void *param, stream_sample_t **inputs, stream_sample_t **outputs, int samples)
 
+typedef void (*stream_journal_func)(device_t *device, void *param, offs_t offset, UINT8 data);
+
+#define STREAM_JOURNAL(name) void name(device_t *device, void *param, offs_t offset, UINT8 data)
+
 
 
 /***************************************************************************
@@ -67,6 +76,15 @@ void stream_set_input(sound_stream *stream, int index, sound_stream *input_strea
 /* force a stream to update to the current emulated time */
 void stream_update(sound_stream *stream);
 
+/* queue a register write that is applied when the stream next generates samples */
+void stream_journal_write(sound_stream *stream, stream_journal_func func, offs_t offset, UINT8 data);
+
+/* stop calling the stream's callback and output silence until it is woken (streams without inputs only) */
+void stream_set_idle(sound_stream *stream);
+
+/* update an idle stream and resume calling its callback; returns the number of samples skipped */
+UINT32 stream_wake(sound_stream *stream);
+
 /* return a pointer to the output buffer and the number of samples since the last global update */
 const stream_sample_t *stream_get_output_since_last_update(sound_stream *stream, int outputnum, int *numsamples);
 
@@ -195,6 +195,9 @@ public:
 	void register_vblank_callback(vblank_state_changed_func vblank_callback, void *param);
 	bitmap_t *alloc_compatible_bitmap(int width = 0, int height = 0) { return auto_bitmap_alloc(machine, (width == 0) ? m_width : width, (height == 0) ? m_height : height, m_config.m_format); }
 
+	// texture holding the most recently completed frame
+	render_texture *texture() const { return m_texture[m_curtexture]; }
+
 	// internal to the video system
 	bool update_quads();
 	void update_burnin();
@@ -99,6 +99,7 @@ struct _core_file
 	zlib_data *		zdata;						/* compression data */
 	UINT32			openflags;					/* flags we were opened with */
 	UINT8			data_allocated;				/* was the data allocated by us? */
+	UINT8			data_mapped;				/* is the data a mapping we own? */
 	UINT8 *			data;						/* file data, if RAM-based */
 	UINT64			offset;						/* current file offset */
 	UINT64			length;						/* total file length */
@@ -119,6 +120,7 @@ struct _core_file
 
 /* misc helpers */
 static UINT32 safe_buffer_copy(const void *source, UINT32 sourceoffs, UINT32 sourcelen, void *dest, UINT32 destoffs, UINT32 destlen);
+static int map_file(core_file *file);
 static file_error osd_or_zlib_read(core_file *file, void *buffer, UINT64 offset, UINT32 length, UINT32 *actual);
 static file_error osd_or_zlib_write(core_file *file, const void *buffer, UINT64 offset, UINT32 length, UINT32 *actual);
 
@@ -233,6 +235,20 @@ file_error core_fopen_ram_copy(const void *data, size_t length, UINT32 openflags
 }
 
 
+/*-------------------------------------------------
+    core_fopen_mapped - open memory returned by
+    osd_map for file-like access, taking it over
+-------------------------------------------------*/
+
+file_error core_fopen_mapped(void *data, size_t length, UINT32 openflags, core_file **file)
+{
+	file_error filerr = core_fopen_ram_internal(data, length, FALSE, openflags, file);
+	if (filerr == FILERR_NONE)
+		(*file)->data_mapped = TRUE;
+	return filerr;
+}
+
+
 /*-------------------------------------------------
     core_fclose - closes a file
 -------------------------------------------------*/
@@ -246,6 +262,8 @@ void core_fclose(core_file *file)
 		osd_close(file->file);
 	if (file->data != NULL && file->data_allocated)
 		free(file->data);
+	if (file->data != NULL && file->data_mapped)
+		osd_unmap(file->data, file->length);
 	free(file);
 }
 
@@ -694,6 +712,10 @@ const void *core_fbuffer(core_file *file)
 	if (file->data != NULL)
 		return file->data;
 
+	/* plain read-only files can be mapped instead of read */
+	if (map_file(file))
+		return file->data;
+
 	/* allocate some memory */
 	file->data = (UINT8 *)malloc(file->length);
 	if (file->data == NULL)
@@ -716,6 +738,30 @@ const void *core_fbuffer(core_file *file)
 }
 
 
+/*-------------------------------------------------
+    core_fmap - take over a mapping of the full
+    file data, creating it if needed; NULL if the
+    data is not mapped and cannot be
+-------------------------------------------------*/
+
+void *core_fmap(core_file *file)
+{
+	/* anything already in RAM only counts if it is a mapping */
+	if (file->data == NULL && !map_file(file))
+		return NULL;
+	if (!file->data_mapped)
+		return NULL;
+
+	/* callers use it as typed memory; stored zip entries can start anywhere */
+	if (((size_t)file->data & 7) != 0)
+		return NULL;
+
+	/* the caller owns it now; we keep reading from it until closed */
+	file->data_mapped = FALSE;
+	return file->data;
+}
+
+
 /*-------------------------------------------------
     core_fload - open a file with the specified
     filename, read it into memory, and return a
@@ -949,6 +995,28 @@ static UINT32 safe_buffer_copy(const void *source, UINT32 sourceoffs, UINT32 sou
 }
 
 
+/*-------------------------------------------------
+    map_file - replace a plain read-only file
+    with a mapping of its full data
+-------------------------------------------------*/
+
+static int map_file(core_file *file)
+{
+	if (file->file == NULL || file->zdata != NULL || (file->openflags & OPEN_FLAG_WRITE) != 0 || file->length > 0xffffffff)
+		return FALSE;
+
+	file->data = (UINT8 *)osd_map(file->file, 0, file->length);
+	if (file->data == NULL)
+		return FALSE;
+	file->data_mapped = TRUE;
+
+	/* close the file because we don't need it anymore */
+	osd_close(file->file);
+	file->file = NULL;
+	return TRUE;
+}
+
+
 /*-------------------------------------------------
     osd_or_zlib_read - wrapper for osd_read that
     handles zlib-compressed data
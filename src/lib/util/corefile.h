@@ -85,6 +85,9 @@ file_error core_fopen_ram(const void *data, size_t length, UINT32 openflags, cor
 /* open a RAM-based "file" using the given data and length (read-only), copying the data */
 file_error core_fopen_ram_copy(const void *data, size_t length, UINT32 openflags, core_file **file);
 
+/* open a RAM-based "file" over memory returned by osd_map (read-only), unmapping it on close */
+file_error core_fopen_mapped(void *data, size_t length, UINT32 openflags, core_file **file);
+
 /* close an open file */
 void core_fclose(core_file *file);
 
@@ -127,6 +130,10 @@ char *core_fgets(char *s, int n, core_file *file);
 /* this function may cause the full file data to be read */
 const void *core_fbuffer(core_file *file);
 
+/* take over the osd_map mapping that backs the full file data, mapping it first if needed; */
+/* returns NULL if the data cannot be mapped or is not 8-byte aligned; release it with osd_unmap after closing the file */
+void *core_fmap(core_file *file);
+
 /* open a file with the specified filename, read it into memory, and return a pointer */
 file_error core_fload(const char *filename, void **data, UINT32 *length);
 
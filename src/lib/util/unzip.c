@@ -38,6 +38,7 @@
 ***************************************************************************/
 
 #include "osdcore.h"
+#include "corestr.h"
 #include "unzip.h"
 
 #include <ctype.h>
@@ -53,6 +54,9 @@
 /* number of open files to cache */
 #define ZIP_CACHE_SIZE	8
 
+/* number of central directory indexes to keep, so parent and BIOS sets stay indexed across games */
+#define ZIP_INDEX_CACHE_SIZE	16
+
 /* offsets in end of central directory structure */
 #define ZIPESIG			0x00
 #define ZIPEDSK			0x04
@@ -116,6 +120,16 @@ INLINE UINT32 read_dword(UINT8 *buf)
 	return (buf[3] << 24) | (buf[2] << 16) | (buf[1] << 8) | buf[0];
 }
 
+INLINE UINT32 hash_name(const char *name)
+{
+	UINT32 hash = 0;
+
+	/* case-insensitive, like the filename matching */
+	while (*name != 0)
+		hash = hash * 31 + tolower((UINT8)*name++);
+	return hash;
+}
+
 
 
 /***************************************************************************
@@ -123,6 +137,7 @@ INLINE UINT32 read_dword(UINT8 *buf)
 ***************************************************************************/
 
 static zip_file *zip_cache[ZIP_CACHE_SIZE];
+static zip_index *zip_index_cache[ZIP_INDEX_CACHE_SIZE];
 
 
 
@@ -132,9 +147,17 @@ static zip_file *zip_cache[ZIP_CACHE_SIZE];
 
 /* cache management */
 static void free_zip_file(zip_file *zip);
+static zip_index *index_cache_find(const char *filename, osd_file *file, UINT64 length);
+static int index_matches_file(zip_index *index, osd_file *file, UINT64 length);
+static void index_cache_add(zip_index *index);
+static void release_zip_index(zip_index *index);
+static void free_zip_index(zip_index *index);
 
 /* ZIP file parsing */
-static zip_error read_ecd(zip_file *zip);
+static zip_error read_ecd(osd_file *file, UINT64 length, zip_ecd *ecd);
+static zip_error read_zip_index(const char *filename, osd_file *file, UINT64 length, zip_index **index);
+static zip_error build_index_tables(zip_index *index);
+static const zip_file_header *read_header(zip_file *zip, UINT32 entrynum);
 static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset);
 
 /* decompression interfaces */
@@ -155,9 +178,7 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 {
 	zip_error ziperr = ZIPERR_NONE;
 	file_error filerr;
-	UINT32 read_length;
 	zip_file *newzip;
-	char *string;
 	int cachenum;
 
 	/* ensure we start with a NULL result */
@@ -191,43 +212,18 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 		goto error;
 	}
 
-	/* read ecd data */
-	ziperr = read_ecd(newzip);
-	if (ziperr != ZIPERR_NONE)
-		goto error;
-
-	/* verify that we can work with this zipfile (no disk spanning allowed) */
-	if (newzip->ecd.disk_number != newzip->ecd.cd_start_disk_number || newzip->ecd.cd_disk_entries != newzip->ecd.cd_total_entries)
+	/* reuse the central directory if we have indexed this file before; otherwise read it in */
+	newzip->index = index_cache_find(filename, newzip->file, newzip->length);
+	if (newzip->index == NULL)
 	{
-		ziperr = ZIPERR_UNSUPPORTED;
-		goto error;
+		ziperr = read_zip_index(filename, newzip->file, newzip->length, &newzip->index);
+		if (ziperr != ZIPERR_NONE)
+			goto error;
+		index_cache_add(newzip->index);
 	}
+	newzip->index->refcount++;
 
-	/* allocate memory for the central directory */
-	newzip->cd = (UINT8 *)malloc(newzip->ecd.cd_size + 1);
-	if (newzip->cd == NULL)
-	{
-		ziperr = ZIPERR_OUT_OF_MEMORY;
-		goto error;
-	}
-
-	/* read the central directory */
-	filerr = osd_read(newzip->file, newzip->cd, newzip->ecd.cd_start_disk_offset, newzip->ecd.cd_size, &read_length);
-	if (filerr != FILERR_NONE || read_length != newzip->ecd.cd_size)
-	{
-		ziperr = (filerr == FILERR_NONE) ? ZIPERR_FILE_TRUNCATED : ZIPERR_FILE_ERROR;
-		goto error;
-	}
-
-	/* make a copy of the filename for caching purposes */
-	string = (char *)malloc(strlen(filename) + 1);
-	if (string == NULL)
-	{
-		ziperr = ZIPERR_OUT_OF_MEMORY;
-		goto error;
-	}
-	strcpy(string, filename);
-	newzip->filename = string;
+	newzip->filename = newzip->index->filename;
 	*zip = newzip;
 	return ZIPERR_NONE;
 
@@ -283,6 +279,11 @@ void zip_file_cache_clear(void)
 			free_zip_file(zip_cache[cachenum]);
 			zip_cache[cachenum] = NULL;
 		}
+
+	/* keep the indexes, but check them against their files when next used */
+	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_index_cache); cachenum++)
+		if (zip_index_cache[cachenum] != NULL)
+			zip_index_cache[cachenum]->validated = FALSE;
 }
 
 
@@ -299,7 +300,7 @@ void zip_file_cache_clear(void)
 const zip_file_header *zip_file_first_file(zip_file *zip)
 {
 	/* reset the position and go from there */
-	zip->cd_pos = 0;
+	zip->entry = 0;
 	return zip_file_next_file(zip);
 }
 
@@ -311,53 +312,67 @@ const zip_file_header *zip_file_first_file(zip_file *zip)
 
 const zip_file_header *zip_file_next_file(zip_file *zip)
 {
-	/* fix up any modified data */
-	if (zip->header.raw != NULL)
+	/* if we're at or past the end, we're done */
+	if (zip->entry >= zip->index->entries)
+		return NULL;
+
+	return read_header(zip, zip->entry);
+}
+
+
+/*-------------------------------------------------
+    zip_file_find_name - return the first entry
+    whose name matches, ignoring any leading
+    directories in the ZIP, and optionally the
+    CRC as well
+-------------------------------------------------*/
+
+const zip_file_header *zip_file_find_name(zip_file *zip, const char *filename, int checkcrc, UINT32 crc)
+{
+	const zip_index *index = zip->index;
+	const char *basename = strrchr(filename, '/');
+	size_t length = strlen(filename);
+	INT32 entrynum;
+
+	/* entries are hashed on their name past the last directory separator */
+	basename = (basename != NULL) ? basename + 1 : filename;
+	for (entrynum = index->namehash[hash_name(basename) & index->hashmask]; entrynum != -1; entrynum = index->entry[entrynum].namenext)
 	{
-		zip->header.raw[ZIPCFN + zip->header.filename_length] = zip->header.saved;
-		zip->header.raw = NULL;
+		const zip_index_entry *entry = &index->entry[entrynum];
+		const char *name = index->names + entry->name;
+		size_t namelength = strlen(name);
+		const char *tail = name + namelength - length;
+
+		/* the name must match in full, or up to a directory separator */
+		if (namelength < length || core_stricmp(tail, filename) != 0 || (tail != name && tail[-1] != '/'))
+			continue;
+		if (checkcrc && read_dword(index->cd + entry->offset + ZIPCCRC) != crc)
+			continue;
+		return read_header(zip, entrynum);
 	}
+	return NULL;
+}
 
-	/* if we're at or past the end, we're done */
-	if (zip->cd_pos >= zip->ecd.cd_size)
-		return NULL;
 
-	/* extract file header info */
-	zip->header.raw                 = zip->cd + zip->cd_pos;
-	zip->header.rawlength           = ZIPCFN;
-	zip->header.signature           = read_dword(zip->header.raw + ZIPCENSIG);
-	zip->header.version_created     = read_word (zip->header.raw + ZIPCVER);
-	zip->header.version_needed      = read_word (zip->header.raw + ZIPCVXT);
-	zip->header.bit_flag            = read_word (zip->header.raw + ZIPCFLG);
-	zip->header.compression         = read_word (zip->header.raw + ZIPCMTHD);
-	zip->header.file_time           = read_word (zip->header.raw + ZIPCTIM);
-	zip->header.file_date           = read_word (zip->header.raw + ZIPCDAT);
-	zip->header.crc                 = read_dword(zip->header.raw + ZIPCCRC);
-	zip->header.compressed_length   = read_dword(zip->header.raw + ZIPCSIZ);
-	zip->header.uncompressed_length = read_dword(zip->header.raw + ZIPCUNC);
-	zip->header.filename_length     = read_word (zip->header.raw + ZIPCFNL);
-	zip->header.extra_field_length  = read_word (zip->header.raw + ZIPCXTL);
-	zip->header.file_comment_length = read_word (zip->header.raw + ZIPCCML);
-	zip->header.start_disk_number   = read_word (zip->header.raw + ZIPDSK);
-	zip->header.internal_attributes = read_word (zip->header.raw + ZIPINT);
-	zip->header.external_attributes = read_dword(zip->header.raw + ZIPEXT);
-	zip->header.local_header_offset = read_dword(zip->header.raw + ZIPOFST);
-	zip->header.filename            = (char *)zip->header.raw + ZIPCFN;
+/*-------------------------------------------------
+    zip_file_find_crc - return the first entry
+    with the given CRC that is not a directory
+-------------------------------------------------*/
 
-	/* make sure we have enough data */
-	zip->header.rawlength += zip->header.filename_length;
-	zip->header.rawlength += zip->header.extra_field_length;
-	zip->header.rawlength += zip->header.file_comment_length;
-	if (zip->cd_pos + zip->header.rawlength > zip->ecd.cd_size)
-		return NULL;
+const zip_file_header *zip_file_find_crc(zip_file *zip, UINT32 crc)
+{
+	const zip_index *index = zip->index;
+	INT32 entrynum;
 
-	/* NULL terminate the filename */
-	zip->header.saved = zip->header.raw[ZIPCFN + zip->header.filename_length];
-	zip->header.raw[ZIPCFN + zip->header.filename_length] = 0;
+	for (entrynum = index->crchash[crc & index->hashmask]; entrynum != -1; entrynum = index->entry[entrynum].crcnext)
+	{
+		const zip_index_entry *entry = &index->entry[entrynum];
+		const char *name = index->names + entry->name;
 
-	/* advance the position */
-	zip->cd_pos += zip->header.rawlength;
-	return &zip->header;
+		if (read_dword(index->cd + entry->offset + ZIPCCRC) == crc && (name[0] == 0 || name[strlen(name) - 1] != '/'))
+			return read_header(zip, entrynum);
+	}
+	return NULL;
 }
 
 
@@ -376,7 +391,7 @@ zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length)
     	return ZIPERR_BUFFER_TOO_SMALL;
 
     /* make sure the info in the header aligns with what we know */
-	if (zip->header.start_disk_number != zip->ecd.disk_number)
+	if (zip->header.start_disk_number != zip->index->ecd.disk_number)
 		return ZIPERR_UNSUPPORTED;
 
     /* get the compressed data offset */
@@ -404,6 +419,35 @@ zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length)
 
 
 
+/*-------------------------------------------------
+    zip_file_map - map a stored (uncompressed)
+    file from a ZIP straight from the archive,
+    leaving the CRC of the data in data_crc
+-------------------------------------------------*/
+
+void *zip_file_map(zip_file *zip)
+{
+	UINT64 offset;
+	void *data;
+
+	/* only stored data can be used in place */
+	if (zip->header.compression != 0 || zip->header.compressed_length != zip->header.uncompressed_length)
+		return NULL;
+	if (zip->header.start_disk_number != zip->index->ecd.disk_number)
+		return NULL;
+
+	/* get the data offset and make sure it is all there */
+	if (get_compressed_data_offset(zip, &offset) != ZIPERR_NONE)
+		return NULL;
+	if (offset + zip->header.uncompressed_length > zip->length)
+		return NULL;
+
+	data = osd_map(zip->file, offset, zip->header.uncompressed_length);
+	if (data != NULL)
+		zip->data_crc = crc32(0, (const Bytef *)data, zip->header.uncompressed_length);
+	return data;
+}
+
 /***************************************************************************
     CACHE MANAGEMENT
 ***************************************************************************/
@@ -419,17 +463,142 @@ static void free_zip_file(zip_file *zip)
 	{
 		if (zip->file != NULL)
 			osd_close(zip->file);
-		if (zip->filename != NULL)
-			free((void *)zip->filename);
-		if (zip->ecd.raw != NULL)
-			free(zip->ecd.raw);
-		if (zip->cd != NULL)
-			free(zip->cd);
+		if (zip->index != NULL)
+			release_zip_index(zip->index);
 		free(zip);
 	}
 }
 
 
+/*-------------------------------------------------
+    index_cache_find - return the cached index
+    of a ZIP file and move it to the top of the
+    cache, provided the file has not changed
+-------------------------------------------------*/
+
+static zip_index *index_cache_find(const char *filename, osd_file *file, UINT64 length)
+{
+	int cachenum;
+
+	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_index_cache); cachenum++)
+	{
+		zip_index *index = zip_index_cache[cachenum];
+
+		if (index != NULL && strcmp(filename, index->filename) == 0)
+		{
+			/* after a cache clear, compare the index with what is in the file now */
+			if (!index->validated)
+				index->validated = index_matches_file(index, file, length);
+
+			/* remove us from where we are, and put us back on top if we are still good */
+			memmove(&zip_index_cache[1], &zip_index_cache[0], cachenum * sizeof(zip_index_cache[0]));
+			zip_index_cache[0] = index;
+			if (index->validated)
+				return index;
+
+			memmove(&zip_index_cache[0], &zip_index_cache[1], (ARRAY_LENGTH(zip_index_cache) - 1) * sizeof(zip_index_cache[0]));
+			zip_index_cache[ARRAY_LENGTH(zip_index_cache) - 1] = NULL;
+			release_zip_index(index);
+			return NULL;
+		}
+	}
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    index_matches_file - return TRUE if the length,
+    the end of central directory and the central
+    directory itself are unchanged; the central
+    directory carries the CRC, sizes and date of
+    every entry
+-------------------------------------------------*/
+
+static int index_matches_file(zip_index *index, osd_file *file, UINT64 length)
+{
+	UINT32 read_length;
+	UINT8 *cd = NULL;
+	zip_ecd ecd;
+	int result = FALSE;
+
+	memset(&ecd, 0, sizeof(ecd));
+	if (length != index->length || read_ecd(file, length, &ecd) != ZIPERR_NONE)
+		goto done;
+	if (ecd.rawlength != index->ecd.rawlength || memcmp(ecd.raw, index->ecd.raw, ecd.rawlength) != 0)
+		goto done;
+
+	/* one more read for the central directory */
+	cd = (UINT8 *)malloc(index->ecd.cd_size + 1);
+	if (cd == NULL)
+		goto done;
+	if (osd_read(file, cd, index->ecd.cd_start_disk_offset, index->ecd.cd_size, &read_length) == FILERR_NONE &&
+			read_length == index->ecd.cd_size && memcmp(cd, index->cd, index->ecd.cd_size) == 0)
+		result = TRUE;
+
+done:
+	if (cd != NULL)
+		free(cd);
+	if (ecd.raw != NULL)
+		free(ecd.raw);
+	return result;
+}
+
+
+/*-------------------------------------------------
+    index_cache_add - add an index to the top of
+    the cache
+-------------------------------------------------*/
+
+static void index_cache_add(zip_index *index)
+{
+	int last = ARRAY_LENGTH(zip_index_cache) - 1;
+
+	/* if no room left in the cache, release the bottommost entry */
+	if (zip_index_cache[last] != NULL)
+		release_zip_index(zip_index_cache[last]);
+
+	/* move everyone else down and place us at the top */
+	memmove(&zip_index_cache[1], &zip_index_cache[0], last * sizeof(zip_index_cache[0]));
+	zip_index_cache[0] = index;
+	index->refcount++;
+}
+
+
+/*-------------------------------------------------
+    release_zip_index - drop a reference to an
+    index, freeing it with the last one
+-------------------------------------------------*/
+
+static void release_zip_index(zip_index *index)
+{
+	if (--index->refcount == 0)
+		free_zip_index(index);
+}
+
+
+/*-------------------------------------------------
+    free_zip_index - free all the data for a
+    zip_index
+-------------------------------------------------*/
+
+static void free_zip_index(zip_index *index)
+{
+	if (index->filename != NULL)
+		free((void *)index->filename);
+	if (index->ecd.raw != NULL)
+		free(index->ecd.raw);
+	if (index->cd != NULL)
+		free(index->cd);
+	if (index->entry != NULL)
+		free(index->entry);
+	if (index->names != NULL)
+		free(index->names);
+	if (index->namehash != NULL)
+		free(index->namehash);
+	free(index);
+}
+
+
 
 /***************************************************************************
     ZIP FILE PARSING
@@ -439,7 +608,7 @@ static void free_zip_file(zip_file *zip)
     read_ecd - read the ECD data
 -------------------------------------------------*/
 
-static zip_error read_ecd(zip_file *zip)
+static zip_error read_ecd(osd_file *file, UINT64 length, zip_ecd *ecd)
 {
 	UINT32 buflen = 1024;
 	UINT8 *buffer;
@@ -452,8 +621,8 @@ static zip_error read_ecd(zip_file *zip)
 		INT32 offset;
 
 		/* max out the buffer length at the size of the file */
-		if (buflen > zip->length)
-			buflen = zip->length;
+		if (buflen > length)
+			buflen = length;
 
 		/* allocate buffer */
 		buffer = (UINT8 *)malloc(buflen + 1);
@@ -461,7 +630,7 @@ static zip_error read_ecd(zip_file *zip)
 			return ZIPERR_OUT_OF_MEMORY;
 
 		/* read in one buffers' worth of data */
-		error = osd_read(zip->file, buffer, zip->length - buflen, buflen, &read_length);
+		error = osd_read(file, buffer, length - buflen, buflen, &read_length);
 		if (error != FILERR_NONE || read_length != buflen)
 		{
 			free(buffer);
@@ -477,29 +646,29 @@ static zip_error read_ecd(zip_file *zip)
 		if (offset >= 0)
 		{
 			/* reuse the buffer as our ECD buffer */
-			zip->ecd.raw = buffer;
-			zip->ecd.rawlength = buflen - offset;
+			ecd->raw = buffer;
+			ecd->rawlength = buflen - offset;
 
 			/* append a NULL terminator to the comment */
-			memmove(&buffer[0], &buffer[offset], zip->ecd.rawlength);
-			zip->ecd.raw[zip->ecd.rawlength] = 0;
+			memmove(&buffer[0], &buffer[offset], ecd->rawlength);
+			ecd->raw[ecd->rawlength] = 0;
 
 			/* extract ecd info */
-			zip->ecd.signature            = read_dword(zip->ecd.raw + ZIPESIG);
-			zip->ecd.disk_number          = read_word (zip->ecd.raw + ZIPEDSK);
-			zip->ecd.cd_start_disk_number = read_word (zip->ecd.raw + ZIPECEN);
-			zip->ecd.cd_disk_entries      = read_word (zip->ecd.raw + ZIPENUM);
-			zip->ecd.cd_total_entries     = read_word (zip->ecd.raw + ZIPECENN);
-			zip->ecd.cd_size              = read_dword(zip->ecd.raw + ZIPECSZ);
-			zip->ecd.cd_start_disk_offset = read_dword(zip->ecd.raw + ZIPEOFST);
-			zip->ecd.comment_length       = read_word (zip->ecd.raw + ZIPECOML);
-			zip->ecd.comment              = (const char *)(zip->ecd.raw + ZIPECOM);
+			ecd->signature            = read_dword(ecd->raw + ZIPESIG);
+			ecd->disk_number          = read_word (ecd->raw + ZIPEDSK);
+			ecd->cd_start_disk_number = read_word (ecd->raw + ZIPECEN);
+			ecd->cd_disk_entries      = read_word (ecd->raw + ZIPENUM);
+			ecd->cd_total_entries     = read_word (ecd->raw + ZIPECENN);
+			ecd->cd_size              = read_dword(ecd->raw + ZIPECSZ);
+			ecd->cd_start_disk_offset = read_dword(ecd->raw + ZIPEOFST);
+			ecd->comment_length       = read_word (ecd->raw + ZIPECOML);
+			ecd->comment              = (const char *)(ecd->raw + ZIPECOM);
 			return ZIPERR_NONE;
 		}
 
 		/* didn't find it; free this buffer and expand our search */
 		free(buffer);
-		if (buflen < zip->length)
+		if (buflen < length)
 			buflen *= 2;
 		else
 			return ZIPERR_BAD_SIGNATURE;
@@ -508,6 +677,200 @@ static zip_error read_ecd(zip_file *zip)
 }
 
 
+/*-------------------------------------------------
+    read_zip_index - read the central directory
+    of a ZIP file and index it
+-------------------------------------------------*/
+
+static zip_error read_zip_index(const char *filename, osd_file *file, UINT64 length, zip_index **result)
+{
+	zip_error ziperr = ZIPERR_NONE;
+	file_error filerr;
+	UINT32 read_length;
+	zip_index *index;
+	char *string;
+
+	/* ensure we start with a NULL result */
+	*result = NULL;
+
+	/* allocate memory for the zip_index structure */
+	index = (zip_index *)malloc(sizeof(*index));
+	if (index == NULL)
+		return ZIPERR_OUT_OF_MEMORY;
+	memset(index, 0, sizeof(*index));
+	index->length = length;
+	index->validated = TRUE;
+
+	/* read ecd data */
+	ziperr = read_ecd(file, length, &index->ecd);
+	if (ziperr != ZIPERR_NONE)
+		goto error;
+
+	/* verify that we can work with this zipfile (no disk spanning allowed) */
+	if (index->ecd.disk_number != index->ecd.cd_start_disk_number || index->ecd.cd_disk_entries != index->ecd.cd_total_entries)
+	{
+		ziperr = ZIPERR_UNSUPPORTED;
+		goto error;
+	}
+
+	/* allocate memory for the central directory */
+	index->cd = (UINT8 *)malloc(index->ecd.cd_size + 1);
+	if (index->cd == NULL)
+	{
+		ziperr = ZIPERR_OUT_OF_MEMORY;
+		goto error;
+	}
+
+	/* read the central directory */
+	filerr = osd_read(file, index->cd, index->ecd.cd_start_disk_offset, index->ecd.cd_size, &read_length);
+	if (filerr != FILERR_NONE || read_length != index->ecd.cd_size)
+	{
+		ziperr = (filerr == FILERR_NONE) ? ZIPERR_FILE_TRUNCATED : ZIPERR_FILE_ERROR;
+		goto error;
+	}
+
+	/* build the lookup tables */
+	ziperr = build_index_tables(index);
+	if (ziperr != ZIPERR_NONE)
+		goto error;
+
+	/* make a copy of the filename for caching purposes */
+	string = (char *)malloc(strlen(filename) + 1);
+	if (string == NULL)
+	{
+		ziperr = ZIPERR_OUT_OF_MEMORY;
+		goto error;
+	}
+	strcpy(string, filename);
+	index->filename = string;
+
+	*result = index;
+	return ZIPERR_NONE;
+
+error:
+	free_zip_index(index);
+	return ziperr;
+}
+
+
+/*-------------------------------------------------
+    build_index_tables - walk the central
+    directory once, copying out the filenames
+    and hashing the entries on name and CRC
+-------------------------------------------------*/
+
+static zip_error build_index_tables(zip_index *index)
+{
+	UINT32 namelength = 0;
+	UINT32 buckets = 16;
+	UINT32 entrynum;
+	UINT32 pos;
+
+	/* count the entries and the space for their names */
+	pos = 0;
+	while (pos + ZIPCFN <= index->ecd.cd_size)
+	{
+		UINT8 *raw = index->cd + pos;
+		UINT32 rawlength = ZIPCFN + read_word(raw + ZIPCFNL) + read_word(raw + ZIPCXTL) + read_word(raw + ZIPCCML);
+
+		/* stop at the first entry that does not fit */
+		if (pos + rawlength > index->ecd.cd_size)
+			break;
+		namelength += read_word(raw + ZIPCFNL) + 1;
+		pos += rawlength;
+		index->entries++;
+	}
+
+	/* keep the hash tables at least as large as the number of entries */
+	while (buckets < index->entries)
+		buckets *= 2;
+	index->hashmask = buckets - 1;
+
+	/* allocate the tables */
+	index->entry = (zip_index_entry *)malloc((index->entries + 1) * sizeof(index->entry[0]));
+	index->names = (char *)malloc(namelength + 1);
+	index->namehash = (INT32 *)malloc(2 * buckets * sizeof(index->namehash[0]));
+	if (index->entry == NULL || index->names == NULL || index->namehash == NULL)
+		return ZIPERR_OUT_OF_MEMORY;
+	index->crchash = index->namehash + buckets;
+	memset(index->namehash, 0xff, 2 * buckets * sizeof(index->namehash[0]));
+
+	/* copy out the names */
+	namelength = 0;
+	for (entrynum = 0, pos = 0; entrynum < index->entries; entrynum++)
+	{
+		UINT8 *raw = index->cd + pos;
+		UINT16 length = read_word(raw + ZIPCFNL);
+
+		index->entry[entrynum].offset = pos;
+		index->entry[entrynum].name = namelength;
+		memcpy(index->names + namelength, raw + ZIPCFN, length);
+		index->names[namelength + length] = 0;
+		namelength += length + 1;
+		pos += ZIPCFN + length + read_word(raw + ZIPCXTL) + read_word(raw + ZIPCCML);
+	}
+
+	/* hash the entries back to front, so that each chain runs in central directory order */
+	for (entrynum = index->entries; entrynum-- > 0; )
+	{
+		zip_index_entry *entry = &index->entry[entrynum];
+		const char *name = index->names + entry->name;
+		const char *basename = strrchr(name, '/');
+		UINT32 bucket;
+
+		bucket = hash_name((basename != NULL) ? basename + 1 : name) & index->hashmask;
+		entry->namenext = index->namehash[bucket];
+		index->namehash[bucket] = entrynum;
+
+		bucket = read_dword(index->cd + entry->offset + ZIPCCRC) & index->hashmask;
+		entry->crcnext = index->crchash[bucket];
+		index->crchash[bucket] = entrynum;
+	}
+	return ZIPERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    read_header - extract the header of an entry
+    and make it the current one
+-------------------------------------------------*/
+
+static const zip_file_header *read_header(zip_file *zip, UINT32 entrynum)
+{
+	const zip_index_entry *entry = &zip->index->entry[entrynum];
+
+	/* extract file header info */
+	zip->header.raw                 = zip->index->cd + entry->offset;
+	zip->header.rawlength           = ZIPCFN;
+	zip->header.signature           = read_dword(zip->header.raw + ZIPCENSIG);
+	zip->header.version_created     = read_word (zip->header.raw + ZIPCVER);
+	zip->header.version_needed      = read_word (zip->header.raw + ZIPCVXT);
+	zip->header.bit_flag            = read_word (zip->header.raw + ZIPCFLG);
+	zip->header.compression         = read_word (zip->header.raw + ZIPCMTHD);
+	zip->header.file_time           = read_word (zip->header.raw + ZIPCTIM);
+	zip->header.file_date           = read_word (zip->header.raw + ZIPCDAT);
+	zip->header.crc                 = read_dword(zip->header.raw + ZIPCCRC);
+	zip->header.compressed_length   = read_dword(zip->header.raw + ZIPCSIZ);
+	zip->header.uncompressed_length = read_dword(zip->header.raw + ZIPCUNC);
+	zip->header.filename_length     = read_word (zip->header.raw + ZIPCFNL);
+	zip->header.extra_field_length  = read_word (zip->header.raw + ZIPCXTL);
+	zip->header.file_comment_length = read_word (zip->header.raw + ZIPCCML);
+	zip->header.start_disk_number   = read_word (zip->header.raw + ZIPDSK);
+	zip->header.internal_attributes = read_word (zip->header.raw + ZIPINT);
+	zip->header.external_attributes = read_dword(zip->header.raw + ZIPEXT);
+	zip->header.local_header_offset = read_dword(zip->header.raw + ZIPOFST);
+	zip->header.filename            = zip->index->names + entry->name;
+
+	zip->header.rawlength += zip->header.filename_length;
+	zip->header.rawlength += zip->header.extra_field_length;
+	zip->header.rawlength += zip->header.file_comment_length;
+
+	/* continue from the following entry */
+	zip->entry = entrynum + 1;
+	return &zip->header;
+}
+
+
 /*-------------------------------------------------
     get_compressed_data_offset - return the
     offset of the compressed data
@@ -561,8 +924,9 @@ static zip_error decompress_data_type_0(zip_file *zip, UINT64 offset, void *buff
 		return ZIPERR_FILE_ERROR;
 	else if (read_length != zip->header.compressed_length)
 		return ZIPERR_FILE_TRUNCATED;
-	else
-		return ZIPERR_NONE;
+
+	zip->data_crc = crc32(0, (const Bytef *)buffer, read_length);
+	return ZIPERR_NONE;
 }
 
 
@@ -573,8 +937,11 @@ static zip_error decompress_data_type_0(zip_file *zip, UINT64 offset, void *buff
 
 static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buffer, UINT32 length)
 {
+    zip_error ziperr = ZIPERR_NONE;
     UINT32 input_remaining = zip->header.compressed_length;
     UINT32 read_length;
+    UINT32 crc = crc32(0, NULL, 0);
+    UINT8 *mapped = NULL;
     z_stream stream;
     int filerr;
     int zerr;
@@ -593,27 +960,40 @@ static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buff
     if (zerr != Z_OK)
     	return ZIPERR_DECOMPRESS_ERROR;
 
+    /* map the compressed data plus the byte after it, if the file has one; */
+    /* then it is all handed to zlib at once rather than read through the buffer */
+    if (input_remaining > 0 && offset + input_remaining < zip->length)
+    	mapped = (UINT8 *)osd_map(zip->file, offset, input_remaining + 1);
+
     /* loop until we're done */
     while (1)
 	{
 		/* read in the next chunk of data */
-		filerr = osd_read(zip->file, zip->buffer, offset, MIN(input_remaining, sizeof(zip->buffer)), &read_length);
-		if (filerr != FILERR_NONE)
+		if (mapped != NULL)
+		{
+			stream.next_in = mapped + (zip->header.compressed_length - input_remaining);
+			read_length = input_remaining;
+		}
+		else
 		{
-			inflateEnd(&stream);
-	    	return ZIPERR_FILE_ERROR;
-	    }
+			filerr = osd_read(zip->file, zip->buffer, offset, MIN(input_remaining, sizeof(zip->buffer)), &read_length);
+			if (filerr != FILERR_NONE)
+			{
+				ziperr = ZIPERR_FILE_ERROR;
+				break;
+			}
+			stream.next_in = zip->buffer;
+		}
 		offset += read_length;
 
 		/* if we read nothing, but still have data left, the file is truncated */
 		if (read_length == 0 && input_remaining > 0)
 		{
-			inflateEnd(&stream);
-			return ZIPERR_FILE_TRUNCATED;
+			ziperr = ZIPERR_FILE_TRUNCATED;
+			break;
 		}
 
 		/* fill out the input data */
-		stream.next_in = zip->buffer;
 		stream.avail_in = read_length;
 		input_remaining -= read_length;
 
@@ -621,19 +1001,26 @@ static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buff
 		if (input_remaining == 0)
 			stream.avail_in++;
 
-		/* now inflate */
+		/* now inflate, checksumming the output while it is still in cache */
+		Bytef *output = stream.next_out;
         zerr = inflate(&stream, Z_NO_FLUSH);
+		crc = crc32(crc, output, stream.next_out - output);
         if (zerr == Z_STREAM_END)
 			break;
 		if (zerr != Z_OK)
 		{
-			inflateEnd(&stream);
-			return ZIPERR_DECOMPRESS_ERROR;
+			ziperr = ZIPERR_DECOMPRESS_ERROR;
+			break;
 		}
     }
 
+	if (mapped != NULL)
+		osd_unmap(mapped, zip->header.compressed_length + 1);
+
 	/* finish decompression */
 	zerr = inflateEnd(&stream);
+	if (ziperr != ZIPERR_NONE)
+		return ziperr;
 	if (zerr != Z_OK)
 		return ZIPERR_DECOMPRESS_ERROR;
 
@@ -641,5 +1028,6 @@ static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buff
 	if (stream.avail_out > 0 || input_remaining > 0)
 		return ZIPERR_DECOMPRESS_ERROR;
 
+	zip->data_crc = crc;
 	return ZIPERR_NONE;
 }
@@ -49,7 +49,10 @@
     CONSTANTS
 ***************************************************************************/
 
-#define ZIP_DECOMPRESS_BUFSIZE	16384
+/* size of the buffer compressed data is read through when it cannot be mapped */
+#ifndef ZIP_DECOMPRESS_BUFSIZE
+#define ZIP_DECOMPRESS_BUFSIZE	65536
+#endif
 
 /* Error types */
 enum _zip_error
@@ -97,7 +100,6 @@ struct _zip_file_header
 
 	UINT8 *			raw;					/* pointer to the raw data */
 	UINT32			rawlength;				/* length of the raw data */
-	UINT8			saved;					/* saved byte from after filename */
 };
 
 
@@ -120,19 +122,50 @@ struct _zip_ecd
 };
 
 
+/* one file in the central directory index */
+typedef struct _zip_index_entry zip_index_entry;
+struct _zip_index_entry
+{
+	UINT32			offset;					/* offset of the header in the central directory */
+	UINT32			name;					/* offset of the NULL-terminated filename in the name pool */
+	INT32			namenext;				/* next entry in the same name hash bucket, or -1 */
+	INT32			crcnext;				/* next entry in the same CRC hash bucket, or -1 */
+};
+
+
+/* parsed central directory of a ZIP file, shared by every open zip_file on it */
+typedef struct _zip_index zip_index;
+struct _zip_index
+{
+	const char *	filename;				/* copy of ZIP filename */
+	UINT64			length;					/* length of zip file when it was indexed */
+	INT32			refcount;				/* number of zip_files and cache slots holding it */
+	UINT8			validated;				/* checked against the file since the last cache clear */
+
+	zip_ecd			ecd;					/* end of central directory */
+	UINT8 *			cd;						/* central directory raw data */
+
+	UINT32			entries;				/* number of files in the central directory */
+	zip_index_entry *entry;					/* per-file data, in central directory order */
+	char *			names;					/* pool of NULL-terminated filenames */
+	UINT32			hashmask;				/* number of hash buckets minus one */
+	INT32 *			namehash;				/* first entry per bucket, hashed on the lowercase name past any directory */
+	INT32 *			crchash;				/* first entry per bucket, hashed on the CRC */
+};
+
+
 /* describes an open ZIP file */
 typedef struct _zip_file zip_file;
 struct _zip_file
 {
-	const char *	filename;				/* copy of ZIP filename (for caching) */
+	const char *	filename;				/* ZIP filename (owned by the index) */
 	osd_file *		file;					/* OSD file handle */
 	UINT64			length;					/* length of zip file */
 
-	zip_ecd			ecd;					/* end of central directory */
-
-	UINT8 *			cd;						/* central directory raw data */
-	UINT32			cd_pos;					/* position in central directory */
+	zip_index *		index;					/* central directory index */
+	UINT32			entry;					/* index of the next entry to return */
 	zip_file_header	header;					/* current file header */
+	UINT32			data_crc;				/* CRC of the data produced by the last decompress */
 
 	UINT8			buffer[ZIP_DECOMPRESS_BUFSIZE];	/* buffer for decompression */
 };
@@ -152,7 +185,7 @@ zip_error zip_file_open(const char *filename, zip_file **zip);
 /* close a ZIP file (may actually be left open due to caching) */
 void zip_file_close(zip_file *zip);
 
-/* clear out all open ZIP files from the cache */
+/* clear out all open ZIP files from the cache; central directory indexes are kept */
 void zip_file_cache_clear(void);
 
 
@@ -164,8 +197,17 @@ const zip_file_header *zip_file_first_file(zip_file *zip);
 /* find the next file in the ZIP */
 const zip_file_header *zip_file_next_file(zip_file *zip);
 
-/* decompress the most recently found file in the ZIP */
+/* find the first file whose name matches, ignoring leading directories in the ZIP, optionally with a given CRC */
+const zip_file_header *zip_file_find_name(zip_file *zip, const char *filename, int checkcrc, UINT32 crc);
+
+/* find the first file (not a directory) with a given CRC */
+const zip_file_header *zip_file_find_crc(zip_file *zip, UINT32 crc);
+
+/* decompress the most recently found file in the ZIP, leaving the CRC of the data in data_crc */
 zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length);
 
+/* map the most recently found file in the ZIP if it is stored uncompressed, leaving the CRC in data_crc; release with osd_unmap */
+void *zip_file_map(zip_file *zip);
+
 
 #endif	/* __UNZIP_H__ */
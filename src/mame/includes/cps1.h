@@ -222,6 +222,9 @@ public:
 	INT32		cps2_last_sprite_offset;		/* Offset of the last sprite */
 	INT32		pri_ctrl;				/* Sprite layer priorities */
 	INT32		objram_bank;
+	const UINT16	*palette_source;			/* gfxram address of the last palette copy */
+	INT32		palette_ctrl;				/* palette control value of the last palette copy */
+	UINT32		palette_dirty[6];			/* 16 colour banks written since the last palette copy, one word per page */
 
 	/* memory size */
 	size_t		gfxram_size;
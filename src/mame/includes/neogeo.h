@@ -40,6 +40,7 @@ public:
 	double		rgb_weights_dark_bit15[5];
 	double		rgb_weights_normal[5];
 	double		rgb_weights_normal_bit15[5];
+	UINT8		rgb_levels[4][32];	/* [dark:bit15][colour:low bit] channel intensities */
 
 	/* video-related */
 	pen_t		*pens;
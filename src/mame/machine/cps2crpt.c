@@ -630,57 +630,45 @@ static void optimise_sboxes(struct optimised_sbox* out, const struct sbox* in)
 
 
 
-static void cps2_decrypt(running_machine *machine, const UINT32 *master_key, UINT32 upper_limit)
+/* one slice of the 0x10000 FN1 seeds, decrypted on the work queue */
+struct decrypt_slice
 {
-	address_space *space = cputag_get_address_space(machine, "maincpu", ADDRESS_SPACE_PROGRAM);
-	UINT16 *rom = (UINT16 *)memory_region(machine, "maincpu");
-	int length = memory_region_length(machine, "maincpu");
-	UINT16 *dec = auto_alloc_array(machine, UINT16, length / 2);
-	int i;
-	UINT32 key1[4];
-	struct optimised_sbox sboxes1[4 * 4];
-	struct optimised_sbox sboxes2[4 * 4];
-
-	optimise_sboxes(&sboxes1[0 * 4], fn1_r1_boxes);
-	optimise_sboxes(&sboxes1[1 * 4], fn1_r2_boxes);
-	optimise_sboxes(&sboxes1[2 * 4], fn1_r3_boxes);
-	optimise_sboxes(&sboxes1[3 * 4], fn1_r4_boxes);
-	optimise_sboxes(&sboxes2[0 * 4], fn2_r1_boxes);
-	optimise_sboxes(&sboxes2[1 * 4], fn2_r2_boxes);
-	optimise_sboxes(&sboxes2[2 * 4], fn2_r3_boxes);
-	optimise_sboxes(&sboxes2[3 * 4], fn2_r4_boxes);
+	const struct optimised_sbox *sboxes1;
+	const struct optimised_sbox *sboxes2;
+	const UINT32 *key1;
+	const UINT32 *master_key;
+	const UINT16 *rom;
+	UINT16 *dec;
+	int length;			/* ROM length in words */
+	UINT32 upper;		/* upper limit of the encrypted range in words */
+	int first;			/* first seed in the slice */
+	int count;			/* number of seeds in the slice */
+};
 
+/* seeds per work item, and seeds between progress updates */
+#define DECRYPT_SLICE_SEEDS		0x100
+#define DECRYPT_BATCH_SEEDS		0x1000
+#define DECRYPT_BATCH_SLICES	(DECRYPT_BATCH_SEEDS / DECRYPT_SLICE_SEEDS)
 
-	// expand master key to 1st FN 96-bit key
-	expand_1st_key(key1, master_key);
 
-	// add extra bits for s-boxes with less than 6 inputs
-	key1[0] ^= BIT(key1[0], 1) <<  4;
-	key1[0] ^= BIT(key1[0], 2) <<  5;
-	key1[0] ^= BIT(key1[0], 8) << 11;
-	key1[1] ^= BIT(key1[1], 0) <<  5;
-	key1[1] ^= BIT(key1[1], 8) << 11;
-	key1[2] ^= BIT(key1[2], 1) <<  5;
-	key1[2] ^= BIT(key1[2], 8) << 11;
 
-	int tmp1 = length / 2;
-	UINT32 tmp2 = upper_limit / 2;
+static void *decrypt_slice_work(void *param, int threadid)
+{
+	const struct decrypt_slice *slice = (const struct decrypt_slice *)param;
+	const struct optimised_sbox *sboxes1 = slice->sboxes1;
+	const struct optimised_sbox *sboxes2 = slice->sboxes2;
+	const UINT32 *key1 = slice->key1;
+	const UINT32 *master_key = slice->master_key;
+	int i;
+	startup_trace_scope trace("decrypt", "cps2op slice", threadid + 1);
 
-	for (i = 0; i < 0x10000; ++i)
+	for (i = slice->first; i < slice->first + slice->count; ++i)
 	{
 		int a;
 		UINT16 seed;
 		UINT32 subkey[2];
 		UINT32 key2[4];
 
-		if ((i & 0xff) == 0)
-		{
-			char loadingMessage[256]; // for displaying with UI
-			sprintf(loadingMessage, "Decrypting %d%%", i * 100 / 0x10000);
-			ui_set_startup_text(machine, loadingMessage, FALSE);
-		}
-
-
 		// pass the address through FN1
 		seed = feistel(i, fn1_groupA, fn1_groupB,
 				&sboxes1[0 * 4], &sboxes1[1 * 4], &sboxes1[2 * 4], &sboxes1[3 * 4],
@@ -709,20 +697,106 @@ static void cps2_decrypt(running_machine *machine, const UINT32 *master_key, UIN
 
 
 		// decrypt the opcodes
-		for (a = i; a < tmp1 && a < tmp2; a += 0x10000)
+		for (a = i; a < slice->length && a < slice->upper; a += 0x10000)
 		{
-			dec[a] = feistel(rom[a], fn2_groupA, fn2_groupB,
+			slice->dec[a] = feistel(slice->rom[a], fn2_groupA, fn2_groupB,
 				&sboxes2[0 * 4], &sboxes2[1 * 4], &sboxes2[2 * 4], &sboxes2[3 * 4],
 				key2[0], key2[1], key2[2], key2[3]);
 		}
 		// copy the unencrypted part (not really needed)
-		while (a < tmp1)
+		while (a < slice->length)
 		{
-			dec[a] = rom[a];
+			slice->dec[a] = slice->rom[a];
 			a += 0x10000;
 		}
 	}
+	return NULL;
+}
+
+
+
+static void cps2_decrypt(running_machine *machine, const UINT32 *master_key, UINT32 upper_limit)
+{
+	address_space *space = cputag_get_address_space(machine, "maincpu", ADDRESS_SPACE_PROGRAM);
+	UINT16 *rom = (UINT16 *)memory_region(machine, "maincpu");
+	int length = memory_region_length(machine, "maincpu");
+	UINT16 *dec = auto_alloc_array(machine, UINT16, length / 2);
+	int i;
+	UINT32 key1[4];
+	struct optimised_sbox sboxes1[4 * 4];
+	struct optimised_sbox sboxes2[4 * 4];
+	struct decrypt_slice slices[0x10000 / DECRYPT_SLICE_SEEDS];
+	osd_work_queue *queue;
+	startup_trace_scope trace("decrypt", "cps2op");
+
+	// a cached copy from an earlier boot of this set saves the whole job
+	if (rom_cache_load(machine, "cps2op", dec, length))
+		goto done;
+
+	optimise_sboxes(&sboxes1[0 * 4], fn1_r1_boxes);
+	optimise_sboxes(&sboxes1[1 * 4], fn1_r2_boxes);
+	optimise_sboxes(&sboxes1[2 * 4], fn1_r3_boxes);
+	optimise_sboxes(&sboxes1[3 * 4], fn1_r4_boxes);
+	optimise_sboxes(&sboxes2[0 * 4], fn2_r1_boxes);
+	optimise_sboxes(&sboxes2[1 * 4], fn2_r2_boxes);
+	optimise_sboxes(&sboxes2[2 * 4], fn2_r3_boxes);
+	optimise_sboxes(&sboxes2[3 * 4], fn2_r4_boxes);
+
+
+	// expand master key to 1st FN 96-bit key
+	expand_1st_key(key1, master_key);
+
+	// add extra bits for s-boxes with less than 6 inputs
+	key1[0] ^= BIT(key1[0], 1) <<  4;
+	key1[0] ^= BIT(key1[0], 2) <<  5;
+	key1[0] ^= BIT(key1[0], 8) << 11;
+	key1[1] ^= BIT(key1[1], 0) <<  5;
+	key1[1] ^= BIT(key1[1], 8) << 11;
+	key1[2] ^= BIT(key1[2], 1) <<  5;
+	key1[2] ^= BIT(key1[2], 8) << 11;
+
+	// every seed owns the words at seed + n * 0x10000, so the slices never overlap
+	for (i = 0; i < ARRAY_LENGTH(slices); i++)
+	{
+		slices[i].sboxes1 = sboxes1;
+		slices[i].sboxes2 = sboxes2;
+		slices[i].key1 = key1;
+		slices[i].master_key = master_key;
+		slices[i].rom = rom;
+		slices[i].dec = dec;
+		slices[i].length = length / 2;
+		slices[i].upper = upper_limit / 2;
+		slices[i].first = i * DECRYPT_SLICE_SEEDS;
+		slices[i].count = DECRYPT_SLICE_SEEDS;
+	}
+
+	// hand out a batch of slices at a time so the progress text keeps moving
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	for (i = 0; i < ARRAY_LENGTH(slices); i += DECRYPT_BATCH_SLICES)
+	{
+		char loadingMessage[256]; // for displaying with UI
+		sprintf(loadingMessage, "Decrypting %d%%", i * DECRYPT_SLICE_SEEDS * 100 / 0x10000);
+		ui_set_startup_text(machine, loadingMessage, FALSE);
+
+		if (queue != NULL)
+		{
+			osd_work_item_queue_multiple(queue, decrypt_slice_work, DECRYPT_BATCH_SLICES, &slices[i], sizeof(slices[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+			// the next batch and the save below need this one done; never leave early
+			while (!osd_work_queue_wait(queue, osd_ticks_per_second() * 100))
+				;
+		}
+		else
+		{
+			int j;
+			for (j = 0; j < DECRYPT_BATCH_SLICES; j++)
+				decrypt_slice_work(&slices[i + j], 0);
+		}
+	}
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+	rom_cache_save(machine, "cps2op", dec, length);
 
+done:
 	space->set_decrypted_region(0x000000, length - 1, dec);
 	m68k_set_encrypted_opcode_range(machine->device("maincpu"), 0, length);
 }
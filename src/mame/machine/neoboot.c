@@ -303,6 +303,36 @@ void decrypt_kf2k5uni( running_machine *machine )
 
 
 // Thanks to IQ_132 for the info
+/* a run of 64KB blocks, unscrambled on the work queue */
+struct kof2002b_gfx_slice
+{
+	UINT8 *src;
+	UINT8 *dst;			/* 64KB scratch buffer for this slice */
+	const int *ofst;	/* where each 128-byte tile of a block goes */
+	int first;			/* offset of the first block */
+	int end;			/* offset past the last block */
+};
+
+/* blocks per work item */
+#define KOF2002B_GFX_SLICE_BLOCKS	16
+
+
+static void *kof2002b_gfx_work(void *param, int threadid)
+{
+	const struct kof2002b_gfx_slice *slice = (const struct kof2002b_gfx_slice *)param;
+	int i, j;
+
+	for ( i = slice->first; i < slice->end; i+=0x10000 )
+	{
+		memcpy( slice->dst, slice->src+i, 0x10000 );
+
+		for ( j = 0; j < 0x200; j++ )
+			memcpy( slice->src+i+slice->ofst[j]*128, slice->dst+j*128, 128 );
+	}
+	return NULL;
+}
+
+
 void kof2002b_gfx_decrypt(running_machine *machine, UINT8 *src, int size)
 {
 	int i, j;
@@ -317,22 +347,46 @@ void kof2002b_gfx_decrypt(running_machine *machine, UINT8 *src, int size)
 		{ 2, 1, 0, 4, 5, 3, 6, 7, 8 },
 		{ 8, 0, 7, 3, 4, 5, 6, 2, 1 },
 	};
+	int ofst[ 0x200 ];
+	int blocks = (size + 0xffff) / 0x10000;
+	int slicecount = (blocks + KOF2002B_GFX_SLICE_BLOCKS - 1) / KOF2002B_GFX_SLICE_BLOCKS;
+	struct kof2002b_gfx_slice *slices = auto_alloc_array(machine, struct kof2002b_gfx_slice, slicecount);
+	UINT8 *dst = auto_alloc_array(machine, UINT8,  0x10000 * slicecount );
+	osd_work_queue *queue;
+
+	/* the tile order is the same in every block */
+	for ( j = 0; j < 0x200; j++ )
+	{
+		int n = (( j % 0x40) / 8 );
+		ofst[j] = BITSWAP16(j, 15, 14, 13, 12, 11, 10, 9, t[n][0], t[n][1], t[n][2],
+							 t[n][3], t[n][4], t[n][5], t[n][6], t[n][7], t[n][8]);
+	}
 
-	UINT8 *dst = auto_alloc_array(machine, UINT8,  0x10000 );
-
-	for ( i = 0; i < size; i+=0x10000 )
+	/* blocks are independent of each other */
+	for ( i = 0; i < slicecount; i++ )
 	{
-		memcpy( dst, src+i, 0x10000 );
+		slices[i].src = src;
+		slices[i].dst = dst + i * 0x10000;
+		slices[i].ofst = ofst;
+		slices[i].first = i * KOF2002B_GFX_SLICE_BLOCKS * 0x10000;
+		slices[i].end = MIN(slices[i].first + KOF2002B_GFX_SLICE_BLOCKS * 0x10000, blocks * 0x10000);
+	}
 
-		for ( j = 0; j < 0x200; j++ )
-		{
-			int n = (( j % 0x40) / 8 );
-			int ofst = BITSWAP16(j, 15, 14, 13, 12, 11, 10, 9, t[n][0], t[n][1], t[n][2],
-								 t[n][3], t[n][4], t[n][5], t[n][6], t[n][7], t[n][8]);
-			memcpy( src+i+ofst*128, dst+j*128, 128 );
-		}
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	if (queue != NULL)
+	{
+		osd_work_item_queue_multiple(queue, kof2002b_gfx_work, slicecount, slices, sizeof(slices[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		/* the slices and the buffers they write are freed below; never leave early */
+		while (!osd_work_queue_wait(queue, osd_ticks_per_second() * 100))
+			;
+		osd_work_queue_free(queue);
 	}
+	else
+		for ( i = 0; i < slicecount; i++ )
+			kof2002b_gfx_work(&slices[i], 0);
+
 	auto_free( machine, dst );
+	auto_free( machine, slices );
 }
 
 
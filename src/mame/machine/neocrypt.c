@@ -528,34 +528,54 @@ static void decrypt(UINT8 *r0, UINT8 *r1,
 }
 
 
-static void neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
+/* one slice of the sprite ROM, decrypted on the work queue */
+struct gfx_decrypt_slice
 {
-	int rom_size;
-	UINT8 *buf;
 	UINT8 *rom;
-	int rpos;
+	UINT8 *buf;
+	int rom_size;
+	int extra_xor;
+	int first;			/* first 32-bit word in the slice */
+	int count;			/* number of words in the slice */
+};
 
-	rom_size = memory_region_length(machine, "sprites");
+/* words per work item */
+#define GFX_DECRYPT_SLICE_WORDS		0x40000
 
-	buf = auto_alloc_array(machine, UINT8, rom_size);
 
-	rom = memory_region(machine, "sprites");
+static void *gfx_data_xor_work(void *param, int threadid)
+{
+	const struct gfx_decrypt_slice *slice = (const struct gfx_decrypt_slice *)param;
+	const UINT8 *rom = slice->rom;
+	UINT8 *buf = slice->buf;
+	int rpos;
+	startup_trace_scope trace("decrypt", "gfx data xor", threadid + 1);
 
-	// Data xor
-	for (rpos = 0;rpos < rom_size/4;rpos++)
+	for (rpos = slice->first; rpos < slice->first + slice->count; rpos++)
 	{
 		decrypt(buf+4*rpos+0, buf+4*rpos+3, rom[4*rpos+0], rom[4*rpos+3], type0_t03, type0_t12, type1_t03, rpos, (rpos>>8) & 1);
 		decrypt(buf+4*rpos+1, buf+4*rpos+2, rom[4*rpos+1], rom[4*rpos+2], type0_t12, type0_t03, type1_t12, rpos, ((rpos>>16) ^ address_16_23_xor2[(rpos>>8) & 0xff]) & 1);
 	}
+	return NULL;
+}
+
+
+static void *gfx_address_xor_work(void *param, int threadid)
+{
+	const struct gfx_decrypt_slice *slice = (const struct gfx_decrypt_slice *)param;
+	int rom_size = slice->rom_size;
+	UINT32 *rom = (UINT32 *)slice->rom;
+	const UINT32 *buf = (const UINT32 *)slice->buf;
+	int rpos;
+	startup_trace_scope trace("decrypt", "gfx address xor", threadid + 1);
 
-	// Address xor
-	for (rpos = 0;rpos < rom_size/4;rpos++)
+	for (rpos = slice->first; rpos < slice->first + slice->count; rpos++)
 	{
 		int baser;
 
 		baser = rpos;
 
-		baser ^= extra_xor;
+		baser ^= slice->extra_xor;
 
 		baser ^= address_8_15_xor1[(baser >> 16) & 0xff] << 8;
 		baser ^= address_8_15_xor2[baser & 0xff] << 8;
@@ -581,17 +601,80 @@ static void neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
 		else /* Clamp to the real rom size */
 			baser &= (rom_size/4)-1;
 
-		rom[4*rpos+0] = buf[4*baser+0];
-		rom[4*rpos+1] = buf[4*baser+1];
-		rom[4*rpos+2] = buf[4*baser+2];
-		rom[4*rpos+3] = buf[4*baser+3];
+		/* the four bytes move together */
+		rom[rpos] = buf[baser];
+	}
+	return NULL;
+}
+
+
+static void run_decrypt_slices(osd_work_queue *queue, osd_work_callback callback, void *slices, int count, int slicesize)
+{
+	int i;
+
+	if (queue != NULL)
+	{
+		osd_work_item_queue_multiple(queue, callback, count, slices, slicesize, WORK_ITEM_FLAG_AUTO_RELEASE);
+
+		/* the slices and the buffers they write are freed after this; never leave early */
+		while (!osd_work_queue_wait(queue, osd_ticks_per_second() * 100))
+			;
+	}
+	else
+		for (i = 0; i < count; i++)
+			(*callback)((UINT8 *)slices + i * slicesize, 0);
+}
+
+
+static void neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
+{
+	const char *stage = (type0_t03 == kof99_type0_t03) ? "cmc42" : "cmc50";
+	struct gfx_decrypt_slice *slices;
+	osd_work_queue *queue;
+	int slicecount;
+	int rom_size;
+	UINT8 *buf;
+	UINT8 *rom;
+	int i;
+	startup_trace_scope trace("decrypt", stage);
+
+	rom_size = memory_region_length(machine, "sprites");
+
+	rom = memory_region(machine, "sprites");
+
+	if (rom_cache_load(machine, stage, rom, rom_size))
+		return;
+
+	buf = auto_alloc_array(machine, UINT8, rom_size);
+
+	// every word is decrypted on its own, so the ROM splits into independent slices
+	slicecount = (rom_size/4 + GFX_DECRYPT_SLICE_WORDS - 1) / GFX_DECRYPT_SLICE_WORDS;
+	slices = auto_alloc_array(machine, struct gfx_decrypt_slice, slicecount);
+	for (i = 0; i < slicecount; i++)
+	{
+		slices[i].rom = rom;
+		slices[i].buf = buf;
+		slices[i].rom_size = rom_size;
+		slices[i].extra_xor = extra_xor;
+		slices[i].first = i * GFX_DECRYPT_SLICE_WORDS;
+		slices[i].count = MIN(GFX_DECRYPT_SLICE_WORDS, rom_size/4 - slices[i].first);
 	}
 
+	// Data xor into buf, then address xor back into the ROM; the second pass reads all of buf
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	run_decrypt_slices(queue, gfx_data_xor_work, slices, slicecount, sizeof(slices[0]));
+	run_decrypt_slices(queue, gfx_address_xor_work, slices, slicecount, sizeof(slices[0]));
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+
+	auto_free(machine, slices);
 	auto_free(machine, buf);
+
+	rom_cache_save(machine, stage, rom, rom_size);
 }
 
 
-/* the S data comes from the end of the C data */
+/* the S data comes from the end of the C data; at 512KB at most it is left serial */
 void neogeo_sfix_decrypt(running_machine *machine)
 {
 	int i;
@@ -1466,61 +1549,140 @@ NeoGeo 'V' (PCM) ROM encryption
 
 ***************************************************************************/
 
+/* one slice of the V ROMs, unscrambled on the work queue */
+struct pcm2_slice
+{
+	UINT8 *rom;
+	const UINT8 *buf;	/* untouched copy of the ROMs (neo_pcm2_swap only) */
+	int value;
+	int first;			/* first 16-bit word (neo_pcm2_snk_1999) or byte (neo_pcm2_swap) */
+	int end;			/* past the last one */
+};
+
+/* words or bytes per work item */
+#define PCM2_SLICE_SIZE				0x100000
+
+
+static int make_pcm2_slices(running_machine *machine, struct pcm2_slice **result, UINT8 *rom, const UINT8 *buf, int value, int count)
+{
+	int slicecount = (count + PCM2_SLICE_SIZE - 1) / PCM2_SLICE_SIZE;
+	struct pcm2_slice *slices = auto_alloc_array(machine, struct pcm2_slice, slicecount);
+	int i;
+
+	for (i = 0; i < slicecount; i++)
+	{
+		slices[i].rom = rom;
+		slices[i].buf = buf;
+		slices[i].value = value;
+		slices[i].first = i * PCM2_SLICE_SIZE;
+		slices[i].end = MIN(slices[i].first + PCM2_SLICE_SIZE, count);
+	}
+	*result = slices;
+	return slicecount;
+}
+
+
+static void *pcm2_snk_1999_work(void *param, int threadid)
+{
+	const struct pcm2_slice *slice = (const struct pcm2_slice *)param;
+	UINT16 *rom = (UINT16 *)slice->rom;
+	int value = slice->value;
+	UINT16 buffer[8];
+	int i, j;
+	startup_trace_scope trace("decrypt", "pcm2 address swap", threadid + 1);
+
+	assert(value <= sizeof(buffer));
+
+	/* the slices are a multiple of the block size, so each block is in one slice */
+	for( i = slice->first; i < slice->end; i += ( value / 2 ) )
+	{
+		memcpy( buffer, &rom[ i ], value );
+		for( j = 0; j < (value / 2); j++ )
+		{
+			rom[ i + j ] = buffer[ j ^ (value/4) ];
+		}
+	}
+	return NULL;
+}
+
+
 /* Neo-Pcm2 Drivers for Encrypted V Roms */
 void neo_pcm2_snk_1999(running_machine *machine, int value)
 {	/* thanks to Elsemi for the NEO-PCM2 info */
 	UINT16 *rom = (UINT16 *)memory_region(machine, "ymsnd");
 	int size = memory_region_length(machine, "ymsnd");
-	int i, j;
+	startup_trace_scope trace("decrypt", "pcm2_snk_1999");
 
 	if( rom != NULL )
-	{	/* swap address lines on the whole ROMs */
-		UINT16 *buffer = auto_alloc_array(machine, UINT16, value / 2);
+	{	/* swap address lines on the whole ROMs; the 4 to 16 byte blocks are independent */
+		struct pcm2_slice *slices;
+		int slicecount = make_pcm2_slices(machine, &slices, (UINT8 *)rom, NULL, value, size / 2);
+		osd_work_queue *queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
 
-		for( i = 0; i < size / 2; i += ( value / 2 ) )
-		{
-			memcpy( buffer, &rom[ i ], value );
-			for( j = 0; j < (value / 2); j++ )
-			{
-				rom[ i + j ] = buffer[ j ^ (value/4) ];
-			}
-		}
-		auto_free(machine, buffer);
+		run_decrypt_slices(queue, pcm2_snk_1999_work, slices, slicecount, sizeof(slices[0]));
+		if (queue != NULL)
+			osd_work_queue_free(queue);
+		auto_free(machine, slices);
 	}
 }
 
 
 /* the later PCM2 games have additional scrambling */
-void neo_pcm2_swap(running_machine *machine, int value)
+static const UINT32 pcm2_swap_addrs[7][2]={
+	{0x000000,0xa5000},
+	{0xffce20,0x01000},
+	{0xfe2cf6,0x4e001},
+	{0xffac28,0xc2000},
+	{0xfeb2c0,0x0a000},
+	{0xff14ea,0xa7001},
+	{0xffb440,0x02000}};
+static const UINT8 pcm2_swap_xordata[7][8]={
+	{0xf9,0xe0,0x5d,0xf3,0xea,0x92,0xbe,0xef},
+	{0xc4,0x83,0xa8,0x5f,0x21,0x27,0x64,0xaf},
+	{0xc3,0xfd,0x81,0xac,0x6d,0xe7,0xbf,0x9e},
+	{0xc3,0xfd,0x81,0xac,0x6d,0xe7,0xbf,0x9e},
+	{0xcb,0x29,0x7d,0x43,0xd2,0x3a,0xc2,0xb4},
+	{0x4b,0xa4,0x63,0x46,0xf0,0x91,0xea,0x62},
+	{0x4b,0xa4,0x63,0x46,0xf0,0x91,0xea,0x62}};
+
+
+static void *pcm2_swap_work(void *param, int threadid)
 {
-	static const UINT32 addrs[7][2]={
-		{0x000000,0xa5000},
-		{0xffce20,0x01000},
-		{0xfe2cf6,0x4e001},
-		{0xffac28,0xc2000},
-		{0xfeb2c0,0x0a000},
-		{0xff14ea,0xa7001},
-		{0xffb440,0x02000}};
-	static const UINT8 xordata[7][8]={
-		{0xf9,0xe0,0x5d,0xf3,0xea,0x92,0xbe,0xef},
-		{0xc4,0x83,0xa8,0x5f,0x21,0x27,0x64,0xaf},
-		{0xc3,0xfd,0x81,0xac,0x6d,0xe7,0xbf,0x9e},
-		{0xc3,0xfd,0x81,0xac,0x6d,0xe7,0xbf,0x9e},
-		{0xcb,0x29,0x7d,0x43,0xd2,0x3a,0xc2,0xb4},
-		{0x4b,0xa4,0x63,0x46,0xf0,0x91,0xea,0x62},
-		{0x4b,0xa4,0x63,0x46,0xf0,0x91,0xea,0x62}};
-	UINT8 *src = memory_region(machine, "ymsnd");
-	UINT8 *buf = auto_alloc_array(machine, UINT8, 0x1000000);
+	const struct pcm2_slice *slice = (const struct pcm2_slice *)param;
+	UINT8 *src = slice->rom;
+	const UINT8 *buf = slice->buf;
+	int value = slice->value;
 	int i, j, d;
+	startup_trace_scope trace("decrypt", "pcm2 swap", threadid + 1);
 
-	memcpy(buf,src,0x1000000);
-	for (i=0;i<0x1000000;i++)
+	/* every source byte lands on its own destination, so the slices never overlap */
+	for (i=slice->first;i<slice->end;i++)
 	{
 		j=BITSWAP24(i,23,22,21,20,19,18,17,0,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,16);
-		j=j^addrs[value][1];
-		d=((i+addrs[value][0])&0xffffff);
-		src[j]=buf[d]^xordata[value][j&0x7];
+		j=j^pcm2_swap_addrs[value][1];
+		d=((i+pcm2_swap_addrs[value][0])&0xffffff);
+		src[j]=buf[d]^pcm2_swap_xordata[value][j&0x7];
 	}
+	return NULL;
+}
+
+
+void neo_pcm2_swap(running_machine *machine, int value)
+{
+	UINT8 *src = memory_region(machine, "ymsnd");
+	UINT8 *buf = auto_alloc_array(machine, UINT8, 0x1000000);
+	struct pcm2_slice *slices;
+	osd_work_queue *queue;
+	int slicecount;
+	startup_trace_scope trace("decrypt", "pcm2_swap");
+
+	memcpy(buf,src,0x1000000);
+	slicecount = make_pcm2_slices(machine, &slices, src, buf, value, 0x1000000);
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	run_decrypt_slices(queue, pcm2_swap_work, slices, slicecount, sizeof(slices[0]));
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+	auto_free(machine, slices);
 	auto_free(machine, buf);
 }
 
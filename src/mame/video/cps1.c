@@ -1814,24 +1814,26 @@ static void cps1_gfx_decode( running_machine *machine )
 {
 	UINT8 *cps1_gfx = memory_region(machine, "gfx");
 	INT32 gfxsize = memory_region_length(machine, "gfx") / 4;
+	UINT32 spread[256];
 
-	for (UINT32 i = 0; i < gfxsize; i++)
+/*	Each source byte holds one bitplane of 8 pixels, MSB first. Spreading a byte
+	so that its bit 7-j lands on bit 4*j gives the plane 0 contribution of all 8
+	nibbles at once; the other planes are the same pattern shifted by 1, 2 and 3. */
+	for (UINT32 i = 0; i < 256; i++)
 	{
-		UINT32 src = cps1_gfx[4 * i] + (cps1_gfx[4 * i + 1] << 8) + (cps1_gfx[4 * i + 2] << 16) + (cps1_gfx[4 * i + 3] << 24);
-		UINT32 dwval = 0;
-
+		spread[i] = 0;
 		for (UINT32 j = 0; j < 8; j++)
-		{
-			INT32 n = 0;
-			UINT32 mask = (0x80808080 >> j) & src;
+			if (i & (0x80 >> j))
+				spread[i] |= 1 << (j * 4);
+	}
 
-			if (mask & 0x000000ff) n |= 1;
-			if (mask & 0x0000ff00) n |= 2;
-			if (mask & 0x00ff0000) n |= 4;
-			if (mask & 0xff000000) n |= 8;
+	for (UINT32 i = 0; i < gfxsize; i++)
+	{
+		UINT32 dwval =	(spread[cps1_gfx[4 * i + 0]] << 0) |
+				(spread[cps1_gfx[4 * i + 1]] << 1) |
+				(spread[cps1_gfx[4 * i + 2]] << 2) |
+				(spread[cps1_gfx[4 * i + 3]] << 3);
 
-			dwval |= n << (j * 4);
-		}
 		cps1_gfx[4 * i + 0] = dwval >>  0;
 		cps1_gfx[4 * i + 1] = dwval >>  8;
 		cps1_gfx[4 * i + 2] = dwval >> 16;
@@ -2028,6 +2030,11 @@ WRITE16_HANDLER( cps1_gfxram_w )
 
 	if (page == (state->cps_a_regs[CPS1_SCROLL3_BASE] & 0x3c0))
 		tilemap_mark_tile_dirty(state->bg_tilemap[2], index);
+
+	/* flag the 16 colour bank for the next palette copy */
+	UINT32 palette_offset = offset - (state->palette_source - state->gfxram);
+	if (palette_offset < state->palette_size / 2)
+		state->palette_dirty[palette_offset >> 9] |= 1 << ((palette_offset >> 4) & 0x1f);
 }
 
 
@@ -2168,7 +2175,12 @@ static void cps1_update_transmasks( running_machine *machine )
 
 static STATE_POSTLOAD( cps_postload )
 {
+	cps_state *state = machine->driver_data<cps_state>();
+
 	cps1_get_video_base(machine);
+
+	/* gfxram was restored behind our back, so the next copy has to redo every bank */
+	memset(state->palette_dirty, 0xff, sizeof(state->palette_dirty));
 }
 
 static VIDEO_START( cps )
@@ -2211,6 +2223,11 @@ static VIDEO_START( cps )
 	memset(state->cps_a_regs, 0, 0x40);				/* Clear CPS-A registers */
 	memset(state->cps_b_regs, 0, 0x40);				/* Clear CPS-B registers */
 
+	/* nothing has been copied to the palette yet */
+	state->palette_source = state->gfxram;
+	state->palette_ctrl = -1;
+	memset(state->palette_dirty, 0xff, sizeof(state->palette_dirty));
+
 	if (state->cps_version == 2)
 	{
 		memset(state->objram1, 0, state->cps2_obj_size);
@@ -2283,6 +2300,16 @@ static void cps1_build_palette(running_machine *machine, const UINT16* const pal
 	const UINT16 *palette_ram = palette_base;
 	INT32 ctrl = state->cps_b_regs[state->game_config->palette_control / 2];
 
+/*	Only the 16 colour banks written through cps1_gfxram_w since the last
+	copy are converted again. Moving the palette base or changing the page
+	layout in the ctrl register invalidates everything. */
+	if (palette_base != state->palette_source || ctrl != state->palette_ctrl)
+	{
+		memset(state->palette_dirty, 0xff, sizeof(state->palette_dirty));
+		state->palette_source = palette_base;
+		state->palette_ctrl = ctrl;
+	}
+
 /*	The palette is copied only for pages that are enabled in the ctrl
 	register. Note that if the first palette pages are skipped, all
 	the following pages are scaled down. */
@@ -2291,21 +2318,29 @@ static void cps1_build_palette(running_machine *machine, const UINT16* const pal
 	{
 		if (BIT(ctrl, page))
 		{
-			for (UINT32 offset = 0; offset < 0x200; ++offset)
+			UINT32 dirty = state->palette_dirty[(palette_ram - palette_base) >> 9];
+
+			for (UINT32 bank = 0; bank < 0x200; bank += 16, palette_ram += 16)
 			{
-				palette = *(palette_ram++);
+				if (!(dirty & (1 << (bank >> 4))))
+					continue;
+
+				for (UINT32 offset = bank; offset < bank + 16; ++offset)
+				{
+					palette = palette_ram[offset - bank];
 
-				/* from my understanding of the schematics, when the 'brightness'
-				   component is set to 0 it should reduce brightness to 1/3 */
+					/* from my understanding of the schematics, when the 'brightness'
+					   component is set to 0 it should reduce brightness to 1/3 */
 
-				bright = 0x0f + ((palette >> 12) << 1);
-				var = bright * 0x11 / 0x2d;
+					bright = 0x0f + ((palette >> 12) << 1);
+					var = bright * 0x11 / 0x2d;
 
-				r = ((palette >> 8) & 0x0f) * var;
-				g = ((palette >> 4) & 0x0f) * var;
-				b = ((palette >> 0) & 0x0f) * var;
+					r = ((palette >> 8) & 0x0f) * var;
+					g = ((palette >> 4) & 0x0f) * var;
+					b = ((palette >> 0) & 0x0f) * var;
 
-				palette_set_color (machine, 0x200 * page + offset, MAKE_RGB(r, g, b));
+					palette_set_color (machine, 0x200 * page + offset, MAKE_RGB(r, g, b));
+				}
 			}
 		}
 		else
@@ -2315,6 +2350,8 @@ static void cps1_build_palette(running_machine *machine, const UINT16* const pal
 				palette_ram += 0x200;
 		}
 	}
+
+	memset(state->palette_dirty, 0, sizeof(state->palette_dirty));
 }
 
 
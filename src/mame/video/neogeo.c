@@ -87,39 +87,37 @@ static void compute_rgb_weights( running_machine *machine )
 						5, resistances, state->rgb_weights_dark_bit15, (8200.0 * 150.0) / (8200.0 + 150.0), 0,
 						0, NULL, NULL, 0, 0,
 						0, NULL, NULL, 0, 0 );
+
+	/* fold the weights into per-channel levels, indexed by the 4 bit colour
+	   value and the shared low bit, so that get_pen is three table lookups */
+	for (UINT32 set = 0; set < 4; set++)
+	{
+		double *weights;
+
+		if (set & 2)
+			weights = (set & 1) ? state->rgb_weights_dark_bit15 : state->rgb_weights_dark;
+		else
+			weights = (set & 1) ? state->rgb_weights_normal_bit15 : state->rgb_weights_normal;
+
+		for (UINT32 level = 0; level < 32; level++)
+			state->rgb_levels[set][level] = combine_5_weights( weights,
+							(level >> 4) & 0x01,
+							(level >> 3) & 0x01,
+							(level >> 2) & 0x01,
+							(level >> 1) & 0x01,
+							(level >> 0) & 0x01 );
+	}
 }
 
-static pen_t get_pen( running_machine *machine, UINT16 data )
+INLINE pen_t get_pen( running_machine *machine, UINT16 data )
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
 
-	double *weights;
+	const UINT8 *levels = state->rgb_levels[(state->screen_dark ? 2 : 0) | (data >> 15)];
 
-	if (state->screen_dark)
-		weights = (data & 0x8000) ? state->rgb_weights_dark_bit15 : state->rgb_weights_dark;
-	else
-		weights = (data & 0x8000) ? state->rgb_weights_normal_bit15 : state->rgb_weights_normal;
-
-	UINT8 r = combine_5_weights( weights,
-						(data >> 11) & 0x01,
-						(data >> 10) & 0x01,
-						(data >>  9) & 0x01,
-						(data >>  8) & 0x01,
-						(data >> 14) & 0x01 );
-
-	UINT8 g = combine_5_weights( weights,
-						(data >>  7) & 0x01,
-						(data >>  6) & 0x01,
-						(data >>  5) & 0x01,
-						(data >>  4) & 0x01,
-						(data >> 13) & 0x01 );
-
-	UINT8 b = combine_5_weights( weights,
-						(data >>  3) & 0x01,
-						(data >>  2) & 0x01,
-						(data >>  1) & 0x01,
-						(data >>  0) & 0x01,
-						(data >> 12) & 0x01 );
+	UINT8 r = levels[((data >> 7) & 0x1e) | ((data >> 14) & 0x01)];
+	UINT8 g = levels[((data >> 3) & 0x1e) | ((data >> 13) & 0x01)];
+	UINT8 b = levels[((data << 1) & 0x1e) | ((data >> 12) & 0x01)];
 
 	return MAKE_RGB(r, g, b);
 }
@@ -171,9 +169,11 @@ WRITE16_HANDLER( neogeo_paletteram_w )
 	neogeo_state *state = space->machine->driver_data<neogeo_state>();
 
 	UINT16 *addr = &state->palettes[state->palette_bank][offset];
+	UINT16 old = *addr;
 	COMBINE_DATA(addr);
 
-	state->pens[offset] = get_pen(space->machine, *addr);
+	if (*addr != old)
+		state->pens[offset] = get_pen(space->machine, *addr);
 }
 
 
@@ -131,6 +131,29 @@ typedef struct _osd_file osd_file;
 file_error osd_open(const char *path, UINT32 openflags, osd_file **file, UINT64 *filesize);
 
 
+/*-----------------------------------------------------------------------------
+    osd_open_anonymous: create an empty file with no name that lives only
+    in memory
+
+    Parameters:
+
+        file - pointer to an osd_file * to receive the newly-created file
+            handle; this is only valid if the function returns FILERR_NONE
+
+    Return value:
+
+        a file_error describing any error that occurred while creating
+        the file, or FILERR_NONE if no error occurred
+
+    Notes:
+
+        The file is filled with osd_write and read back with osd_read or
+        osd_map; its memory is released once it is closed and no mappings
+        of it remain. Platforms without such files return FILERR_FAILURE.
+-----------------------------------------------------------------------------*/
+file_error osd_open_anonymous(osd_file **file);
+
+
 /*-----------------------------------------------------------------------------
     osd_close: close an open file
 
@@ -196,6 +219,40 @@ file_error osd_read(osd_file *file, void *buffer, UINT64 offset, UINT32 length,
 file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 length, UINT32 *actual);
 
 
+/*-----------------------------------------------------------------------------
+    osd_map: map part of an open file into memory
+
+    Parameters:
+
+        file - handle to a file previously opened via osd_open
+
+        offset - offset within the file of the first byte to map; it need
+            not be aligned to anything
+
+        length - number of bytes to map
+
+    Return value:
+
+        a pointer to the byte at offset, or NULL if the file cannot be
+        mapped; the memory is writable but changes stay private to the
+        process, and it remains valid after the file is closed, until it
+        is released with osd_unmap
+-----------------------------------------------------------------------------*/
+void *osd_map(osd_file *file, UINT64 offset, UINT32 length);
+
+
+/*-----------------------------------------------------------------------------
+    osd_unmap: release memory mapped by osd_map
+
+    Parameters:
+
+        base - the pointer returned by osd_map
+
+        length - the length passed to osd_map
+-----------------------------------------------------------------------------*/
+void osd_unmap(void *base, UINT32 length);
+
+
 /*-----------------------------------------------------------------------------
     osd_rmfile: deletes a file
 
@@ -287,6 +344,7 @@ struct _osd_directory_entry
 	const char *		name;			/* name of the entry */
 	osd_dir_entry_type	type;			/* type of the entry */
 	UINT64				size;			/* size of the entry */
+	UINT64				modified;		/* last modification time in seconds, or 0 if unknown */
 };
 
 
@@ -4,6 +4,7 @@
 #include "emu.h"
 #include "clifront.h"
 #include "render.h"
+#include "rendutil.h"
 #include "ui.h"
 #include "uiinput.h"
 #include "libretro.h"
@@ -193,6 +194,12 @@ static const struct _neogeo_bioses	neogeo_bioses[] = {
 
 // extern variables
 bool verify_rom_hash = false;
+bool verify_rom_zip_crc = false;
+bool cache_decrypted_roms = false;
+bool cache_rom_audit = false;
+bool cache_rom_regions = false;
+bool native_sample_rate = false;
+int stream_resampler = STREAM_RESAMPLER_DEFAULT;
 bool allow_select_newgame = false;
 bool RETRO_LOOP = true;
 
@@ -228,6 +235,7 @@ static bool keyboard_input = true;
 static bool macro_enable = true;
 static bool is_neogeo = false;
 static bool do_cheat = true;	// TODO: add core option
+static bool direct_video = false;
 
 static INT32 rtwi = 320, rthe = 240, topw = 320;	/* DEFAULT TEXW/TEXH/PITCH */
 static INT32 ui_ipt_pushchar = -1;
@@ -241,8 +249,13 @@ static UINT32 screenRot = 0;
 static UINT32 pauseg = 0;
 static UINT32 mame_reset = 0;
 static UINT32 FirstTimeUpdate = 1;
+static bool startup_trace = false;
+static char startup_trace_path[1024];
+static bool sound_log = false;
+static char sound_log_path[1024];
 static UINT32 macro_state;
 static UINT32 sample_rate = 48000;
+static unsigned audio_latency = 0;	/* target frontend latency in ms; 0 passes audio straight through */
 static UINT32 adjust_opt[7] = { 0/*Enable/Disable*/, 0/*Limit*/, 0/*GetRefreshRate*/, 0/*Brightness*/, 0/*Contrast*/, 0/*Gamma*/, 0/*Overclock*/ };
 static float arroffset[4] = { 0/*For brightness*/, 0/*For contrast*/, 0/*For gamma*/, 1.0/*For overclock*/ };
 static double refresh_rate = 60.0;
@@ -324,6 +337,10 @@ static void retro_poll_mame_input(void);
 
 #include "rendersw.c"
 
+/* the frame handed to the frontend; videoBuffer unless presented directly */
+static void *frame_data = videoBuffer;
+static size_t frame_pitch;
+
 retro_log_printf_t log_cb = NULL;
 retro_environment_t environ_cb = NULL;
 retro_video_refresh_t video_cb = NULL;
@@ -388,6 +405,119 @@ static void extract_directory(char *buf, const char *path, size_t size)
 }
 
 
+/**************************************************************************/
+//	AUDIO SYNC
+/**************************************************************************/
+
+/*
+	The frontend refreshes at 59.94/60Hz while most of our games run a little
+	off that, so handing over exactly what the emulator generated slowly
+	drains or floods the frontend's buffer. When a target latency is set,
+	each frame's samples go through a small ring and are linearly resampled
+	out at a rate nudged by the frontend's buffer occupancy, keeping it
+	half full.
+*/
+
+#define AUDIO_RING_FRAMES	8192	/* stereo frames; must be a power of two */
+#define AUDIO_OUT_FRAMES	1024	/* frames handed to the frontend per batch */
+#define AUDIO_MAX_SKEW		0.005	/* largest rate correction, +/-0.5% */
+
+static INT16 audio_ring[AUDIO_RING_FRAMES * 2];
+static INT16 audio_out[AUDIO_OUT_FRAMES * 2];
+static UINT32 audio_rd, audio_wr;	/* ring positions, in frames */
+static UINT32 audio_frac;		/* 0.16 position between audio_rd and the next frame */
+static bool audio_status_ok = false;	/* the frontend reports its buffer status */
+static bool audio_status_active = false;
+static unsigned audio_occupancy = 50;
+static bool audio_underrun_likely = false;
+
+static void audio_buffer_status(bool active, unsigned occupancy, bool underrun_likely)
+{
+	audio_status_active = active;
+	audio_occupancy = occupancy;
+	audio_underrun_likely = underrun_likely;
+}
+
+static void audio_sync_configure(void)
+{
+	struct retro_audio_buffer_status_callback buf_status;
+
+	buf_status.callback = audio_buffer_status;
+	audio_status_ok = audio_latency && environ_cb(RETRO_ENVIRONMENT_SET_AUDIO_BUFFER_STATUS_CALLBACK, &buf_status);
+	if (!audio_status_ok)
+		environ_cb(RETRO_ENVIRONMENT_SET_AUDIO_BUFFER_STATUS_CALLBACK, NULL);
+
+	/* 0 hands the buffer size back to the frontend */
+	environ_cb(RETRO_ENVIRONMENT_SET_MINIMUM_AUDIO_LATENCY, &audio_latency);
+
+	audio_status_active = false;
+	audio_rd = audio_wr = audio_frac = 0;
+}
+
+static void audio_sync_push(const INT16 *buffer, int frames)
+{
+	/* keep the newest audio if the ring would overflow */
+	if (frames > AUDIO_RING_FRAMES)
+	{
+		buffer += (frames - AUDIO_RING_FRAMES) * 2;
+		frames = AUDIO_RING_FRAMES;
+	}
+	if (audio_wr - audio_rd + frames > AUDIO_RING_FRAMES)
+	{
+		audio_rd = audio_wr + frames - AUDIO_RING_FRAMES;
+		audio_frac = 0;
+	}
+
+	while (frames > 0)
+	{
+		UINT32 pos = audio_wr & (AUDIO_RING_FRAMES - 1);
+		int chunk = MIN(frames, (int)(AUDIO_RING_FRAMES - pos));
+
+		memcpy(&audio_ring[pos * 2], buffer, chunk * 2 * sizeof(*buffer));
+		buffer += chunk * 2;
+		frames -= chunk;
+		audio_wr += chunk;
+	}
+}
+
+static void audio_sync_pull(void)
+{
+	double ratio;
+	UINT32 step;
+	int count = 0;
+
+	/* more output than input when the frontend runs low, less when it fills up */
+	if (audio_underrun_likely)
+		ratio = 1.0 + AUDIO_MAX_SKEW;
+	else
+		ratio = 1.0 + AUDIO_MAX_SKEW * (50.0 - (double)MIN(audio_occupancy, 100)) / 50.0;
+	step = (UINT32)(65536.0 / ratio + 0.5);
+
+	/* each output frame needs the ring frame after audio_rd to interpolate */
+	while (audio_wr - audio_rd >= 2)
+	{
+		const INT16 *a = &audio_ring[(audio_rd & (AUDIO_RING_FRAMES - 1)) * 2];
+		const INT16 *b = &audio_ring[((audio_rd + 1) & (AUDIO_RING_FRAMES - 1)) * 2];
+		INT32 frac = audio_frac >> 1;
+
+		audio_out[count * 2 + 0] = a[0] + (((b[0] - a[0]) * frac) >> 15);
+		audio_out[count * 2 + 1] = a[1] + (((b[1] - a[1]) * frac) >> 15);
+		if (++count == AUDIO_OUT_FRAMES)
+		{
+			audio_batch_cb(audio_out, count);
+			count = 0;
+		}
+
+		audio_frac += step;
+		audio_rd += audio_frac >> 16;
+		audio_frac &= 0xffff;
+	}
+
+	if (count)
+		audio_batch_cb(audio_out, count);
+}
+
+
 /**************************************************************************/
 
 void retro_set_environment(retro_environment_t cb)
@@ -401,8 +531,16 @@ void retro_set_environment(retro_environment_t cb)
 	{ "mba_mini_kb_input",		"Keyboard input; enabled|disabled" },
 	{ "mba_mini_macro_button", 	"Use macro button; disabled|assign A+B to L|assign A+B to R|assign C+D to L|assign C+D to R|assign A+B to L & C+D to R|assign A+B to R & C+D to L" },
 	{ "mba_mini_tate_mode", 	"T.A.T.E mode(Restart); disabled|enabled" },
-	{ "mba_mini_sample_rate", 	"Set sample rate (Restart); 48000Hz|44100Hz|32000Hz|22050Hz" },
-	{ "mba_mini_rom_hash",		"Forced off ROM CRC verfiy(Restart); No|Yes" },
+	{ "mba_mini_sample_rate", 	"Set sample rate (Restart); 48000Hz|44100Hz|32000Hz|22050Hz|native" },
+	{ "mba_mini_resampler", 	"Audio resampler (Restart); default|linear|polyphase" },
+	{ "mba_mini_audio_latency",	"Audio sync target latency; disabled|32ms|48ms|64ms|96ms|128ms" },
+	{ "mba_mini_rom_hash",		"Forced off ROM CRC verfiy(Restart); No|Yes|Zip CRC only" },
+	{ "mba_mini_decrypt_cache",	"Cache decrypted ROMs(Restart); disabled|enabled" },
+	{ "mba_mini_audit_cache",	"Remember verified ROM sets(Restart); disabled|enabled" },
+	{ "mba_mini_region_cache",	"Keep ROMs in memory between restarts, uses up to 64MB extra RAM(Restart); disabled|enabled" },
+	{ "mba_mini_startup_trace",	"Write a startup trace(Restart); disabled|enabled" },
+	{ "mba_mini_sound_log",		"Record a sound register log(Restart); disabled|enabled" },
+	{ "mba_mini_direct_video",	"Direct video output; disabled|enabled" },
 	{ "mba_mini_neogeo_bios",
 #if defined(USE_FULLY)
 	  "Set NEOGEO BIOS(Restart); Default|Europe MVS(Ver. 2)|Europe MVS(Ver. 1)|USA MVS(Ver. 2?)|USA MVS(Ver. 1)|Asia MVS(Ver. 3)|Asia MVS(Latest)|Japan MVS(Ver. 3)|Japan MVS(Ver. 2)|Japan MVS(Ver. 1)|Japan MVS(J3)|Custom Japanese Hotel|UniBIOS(Ver. 3.2)|UniBIOS(Ver. 3.1)|UniBIOS(Ver. 3.0)|UniBIOS(Ver. 2.3)|UniBIOS(Ver. 2.3 older?)|UniBIOS(Ver. 2.2)|UniBIOS(Ver. 2.1)|UniBIOS(Ver. 2.0)|UniBIOS(Ver. 1.3)|UniBIOS(Ver. 1.2)|UniBIOS(Ver. 1.2 older)|UniBIOS(Ver. 1.1)|UniBIOS(Ver. 1.0)|Debug MVS|Asia AES|Japan AES" },
@@ -521,7 +659,38 @@ static void check_variables(void)
 	var.key = "mba_mini_sample_rate";
 	var.value = NULL;
 	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
-		sample_rate = atoi(var.value);
+	{
+		/* in native mode the sound system picks the rate once the chips are up */
+		native_sample_rate = !strcmp(var.value, "native");
+		if (!native_sample_rate)
+			sample_rate = atoi(var.value);
+	}
+
+	var.key = "mba_mini_resampler";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "linear"))
+			stream_resampler = STREAM_RESAMPLER_LINEAR;
+		else if (!strcmp(var.value, "polyphase"))
+			stream_resampler = STREAM_RESAMPLER_POLYPHASE;
+		else
+			stream_resampler = STREAM_RESAMPLER_DEFAULT;
+	}
+
+	var.key = "mba_mini_audio_latency";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		unsigned temp_latency = audio_latency;
+		if (!strcmp(var.value, "disabled"))
+			audio_latency = 0;
+		else
+			audio_latency = atoi(var.value);
+
+		if (temp_latency != audio_latency)
+			audio_sync_configure();
+	}
 
 	var.key = "mba_mini_adj_brightness";
 	var.value = NULL;
@@ -606,12 +775,73 @@ static void check_variables(void)
 	var.value = NULL;
 	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
 	{
-		if (!strcmp(var.value, "No"))
+		verify_rom_zip_crc = !strcmp(var.value, "Zip CRC only");
+		if (!strcmp(var.value, "No") || verify_rom_zip_crc)
 			verify_rom_hash = true;
 		else
 			verify_rom_hash = false;
 	}
 
+	var.key = "mba_mini_decrypt_cache";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			cache_decrypted_roms = true;
+		else
+			cache_decrypted_roms = false;
+	}
+
+	var.key = "mba_mini_audit_cache";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			cache_rom_audit = true;
+		else
+			cache_rom_audit = false;
+	}
+
+	var.key = "mba_mini_region_cache";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			cache_rom_regions = true;
+		else
+			cache_rom_regions = false;
+	}
+
+	var.key = "mba_mini_startup_trace";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			startup_trace = true;
+		else
+			startup_trace = false;
+	}
+
+	var.key = "mba_mini_sound_log";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			sound_log = true;
+		else
+			sound_log = false;
+	}
+
+	var.key = "mba_mini_direct_video";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			direct_video = true;
+		else
+			direct_video = false;
+	}
+
 	if (tmp_ar != set_par)
 		update_geometry();
 }
@@ -739,17 +969,32 @@ void retro_run (void)
       		check_variables();
 
 	retro_poll_mame_input();
-	retro_main_loop();
+
+	/* the call right after loading only returns from the frame the startup screens began */
+	bool emulated = RETRO_LOOP;
+	{
+		startup_trace_scope trace("retro", "retro_run");
+		retro_main_loop();
+	}
 
 	RETRO_LOOP = true;
 
+	/* the trace ends with the first emulated frame */
+	if (g_startup_trace && emulated)
+	{
+		if (startup_trace_stop(startup_trace_path))
+			LOGI("Startup trace written to %s\n", startup_trace_path);
+		else
+			LOGI("Unable to write startup trace %s\n", startup_trace_path);
+	}
+
 #if defined(HAVE_OPENGL) || defined(HAVE_OPENGLES)
 	do_gl2d();
 #else
 	if (draw_this_frame)
-		video_cb(videoBuffer, rtwi, rthe, topw << PITCH);
+		video_cb(frame_data, rtwi, rthe, frame_pitch);
 	else
-		video_cb(	NULL, rtwi, rthe, topw << PITCH);
+		video_cb(	NULL, rtwi, rthe, frame_pitch);
 #endif
 }
 
@@ -762,6 +1007,8 @@ bool retro_load_game(const struct retro_game_info *info)
 {
 	struct retro_log_callback log;
 	char basename[128];
+	const char *savedir = NULL;
+	osd_ticks_t origin = osd_ticks();
 #ifdef M16B
 	enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_RGB565;
 #else
@@ -777,7 +1024,14 @@ bool retro_load_game(const struct retro_game_info *info)
 #else
 	memset(videoBuffer, 0, 1024 * 1024 * 2 * 2);
 #endif
+	frame_data = videoBuffer;
+	frame_pitch = topw << PITCH;
 	check_variables();
+	if (startup_trace)
+	{
+		startup_trace_start(origin);
+		startup_trace_add("retro", "check_variables", 0, origin, osd_ticks());
+	}
 
 #if defined(HAVE_OPENGL) || defined(HAVE_OPENGLES)
    #ifdef HAVE_OPENGLES
@@ -798,6 +1052,12 @@ bool retro_load_game(const struct retro_game_info *info)
 	extract_directory(retro_content_dir, info->path, sizeof(retro_content_dir));
 	strcpy(RETRO_GAME_PATH, info->path);
 
+	// the trace and the sound log go with the saves; the content directory may be read-only
+	if (!environ_cb(RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY, &savedir) || !savedir || !savedir[0])
+		savedir = retro_content_dir;
+	snprintf(startup_trace_path, sizeof(startup_trace_path), "%s%c%s-startup.json", savedir, slash, basename);
+	snprintf(sound_log_path, sizeof(sound_log_path), "%s%c%s.sndlog", savedir, slash, basename);
+
 	int result = mmain(1, RETRO_GAME_PATH);
 
 	if (result != 1)
@@ -821,6 +1081,7 @@ bool retro_load_game(const struct retro_game_info *info)
 	if (log_cb)
 		log_cb(RETRO_LOG_INFO, "CONTENT_DIRECTORY: %s", retro_content_dir);
 
+	startup_trace_add("retro", "retro_load_game", 0, origin, osd_ticks());
 	return 1;
 }
 
@@ -829,6 +1090,9 @@ void retro_unload_game(void)
 	if (!pauseg)
 		pauseg = 1;
 
+	frame_data = videoBuffer;
+	frame_pitch = topw << PITCH;
+
 	LOGI("M.B.A_more has unload the game.\n");
 }
 
@@ -1166,6 +1430,10 @@ void osd_exit(running_machine &machine)
 
 	our_target = NULL;
 
+	/* direct video may have left frame_data pointing into a screen bitmap */
+	frame_data = videoBuffer;
+	frame_pitch = topw << PITCH;
+
 	global_free(keyboard_device);
 	global_free(joypad4_device);
 	global_free(joypad3_device);
@@ -1206,6 +1474,96 @@ void osd_init(running_machine *machine)
 /*	LOGI("osd init done\n");	*/
 }
 
+/*-------------------------------------------------
+    direct_draw_screen - present the screen bitmap
+    without going through the render system;
+    returns false if the render system is needed
+-------------------------------------------------*/
+
+static bool direct_draw_screen(running_machine *machine)
+{
+	screen_device *screen = screen_first(*machine);
+	render_container_user_settings settings;
+	render_container *container;
+	const rgb_t *palette;
+	bitmap_t *bitmap;
+	rectangle sbounds;
+	int format, orientation;
+
+	/* single screen only, and nothing from the UI on top of it */
+	if (screen == NULL || screen_next(screen) != NULL)
+		return false;
+	if (!render_container_is_empty(render_container_get_ui()))
+		return false;
+
+	/* crosshairs, overlays and the like are drawn into the screen container */
+	container = render_container_get_screen(screen);
+	if (!render_container_is_texture_only(container, screen->texture()))
+		return false;
+	if (!render_texture_get_source(screen->texture(), container, &bitmap, &sbounds, &format, &palette))
+		return false;
+	if (format != TEXFORMAT_PALETTE16 && format != TEXFORMAT_RGB32)
+		return false;
+
+	/* user scaling or offsets need the render system */
+	render_container_get_user_settings(container, &settings);
+	if (settings.xscale != 1.0f || settings.yscale != 1.0f || settings.xoffset != 0.0f || settings.yoffset != 0.0f)
+		return false;
+
+	/* the combined screen and target orientation takes care of TATE as well */
+	orientation = orientation_add(settings.orientation, render_target_get_orientation(our_target));
+
+	INT32 width = sbounds.max_x - sbounds.min_x;
+	INT32 height = sbounds.max_y - sbounds.min_y;
+	if (orientation & ORIENTATION_SWAP_XY)
+	{
+		INT32 temp = width;
+		width = height;
+		height = temp;
+	}
+	if (width != rtwi || height != rthe)
+		return false;
+
+#ifndef M16B
+	/* zero copy: an unadjusted RGB32 bitmap is already in the frontend's format */
+	if (format == TEXFORMAT_RGB32 && palette == NULL && (orientation & ORIENTATION_MASK) == ROT0)
+	{
+		frame_data = BITMAP_ADDR32(bitmap, sbounds.min_y, sbounds.min_x);
+		frame_pitch = bitmap->rowpixels * sizeof(UINT32);
+		return true;
+	}
+#endif
+
+	/* otherwise convert once, into the frontend's framebuffer if it offers one */
+	struct retro_framebuffer fb;
+	memset(&fb, 0, sizeof(fb));
+	fb.width = rtwi;
+	fb.height = rthe;
+	fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+
+#ifdef M16B
+	if (environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) && fb.data != NULL && fb.format == RETRO_PIXEL_FORMAT_RGB565)
+#else
+	if (environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) && fb.data != NULL && fb.format == RETRO_PIXEL_FORMAT_XRGB8888)
+#endif
+	{
+		frame_data = fb.data;
+		frame_pitch = fb.pitch;
+	}
+	else
+	{
+		frame_data = videoBuffer;
+		frame_pitch = topw << PITCH;
+	}
+
+#ifdef M16B
+	rgb565_draw_bitmap(bitmap, &sbounds, format, palette, orientation, frame_data, frame_pitch >> PITCH);
+#else
+	rgb888_draw_bitmap(bitmap, &sbounds, format, palette, orientation, frame_data, frame_pitch >> PITCH);
+#endif
+	return true;
+}
+
 void osd_update(running_machine *machine, int skip_redraw)
 {
 	const render_primitive_list	*primlist;
@@ -1299,22 +1657,31 @@ void osd_update(running_machine *machine, int skip_redraw)
 				}
 			}
 		}
-		/* make that the size of our target */
-		render_target_set_bounds(our_target, rtwi, rthe, 0);
+#if !defined(HAVE_OPENGL) && !defined(HAVE_OPENGLES)
+		/* present the screen bitmap directly when nothing else needs drawing */
+		if (!direct_video || !direct_draw_screen(machine))
+#endif
+		{
+			/* make that the size of our target */
+			render_target_set_bounds(our_target, rtwi, rthe, 0);
 
-		/* get the list of primitives for the target at the current size */
-		primlist = render_target_get_primitives(our_target);
+			/* get the list of primitives for the target at the current size */
+			primlist = render_target_get_primitives(our_target);
 
-		/* lock them, and then render them */
-		osd_lock_acquire(primlist->lock);
+			/* lock them, and then render them */
+			osd_lock_acquire(primlist->lock);
 
-		surfptr = (UINT8 *)videoBuffer;
+			surfptr = (UINT8 *)videoBuffer;
 #ifdef M16B
-		rgb565_draw_primitives(primlist->head, surfptr, rtwi, rthe, rtwi);
+			rgb565_draw_primitives(primlist->head, surfptr, rtwi, rthe, rtwi);
 #else
-		rgb888_draw_primitives(primlist->head, surfptr, rtwi, rthe, rtwi);
+			rgb888_draw_primitives(primlist->head, surfptr, rtwi, rthe, rtwi);
 #endif
-		osd_lock_release(primlist->lock);
+			osd_lock_release(primlist->lock);
+
+			frame_data = videoBuffer;
+			frame_pitch = topw << PITCH;
+		}
 	}
 	else
 		draw_this_frame = false;
@@ -1345,8 +1712,28 @@ void osd_wait_for_debugger(running_device *device, int firststop)
 //============================================================
 void osd_update_audio_stream(running_machine *machine, short *buffer, int samples_this_frame)
 {
-	if (!pauseg)
+	/* the sound system switched to the chips' native rate; let the frontend resample */
+	if (native_sample_rate && sample_rate != (UINT32)machine->sample_rate)
+	{
+		struct retro_system_av_info av_info;
+
+		sample_rate = machine->sample_rate;
+		retro_get_system_av_info(&av_info);
+		environ_cb(RETRO_ENVIRONMENT_SET_SYSTEM_AV_INFO, &av_info);
+	}
+
+	if (pauseg)
+		return;
+
+	/* without buffer status from the frontend there is nothing to steer by */
+	if (!audio_status_ok || !audio_status_active)
+	{
 		audio_batch_cb(buffer, samples_this_frame);
+		return;
+	}
+
+	audio_sync_push(buffer, samples_this_frame);
+	audio_sync_pull();
 }
 
 //============================================================
@@ -1417,25 +1804,28 @@ static int parsePath(char *path, char *gamePath, char *gameName)
 
 static int getGameInfo(char *gameName, int *rotation, int *driverIndex)
 {
-	int gameFound = 0;
+	int drvindex = -1;
 
 	/* check invalid game name */
 	if (gameName[0] == 0)
-		return gameFound;
+		return 0;
 
-	for (int drvindex = 0; drivers[drvindex]; drvindex++)
-	{
-		if ( (drivers[drvindex]->flags & GAME_NO_STANDALONE) == 0 && mame_strwildcmp(gameName, drivers[drvindex]->name) == 0 )
-		{
-			gameFound = 1;
-			*driverIndex = drvindex;
-			*rotation = drivers[drvindex]->flags & 0x07;
-/*			LOGI("%-18s\"%s\" rot=%i\n", drivers[drvindex]->name, drivers[drvindex]->description, *rotation); */
-			if (strcmp(drivers[drvindex]->source_file, "src/mame/drivers/neogeo/neogeo.inc") == 0)
-				is_neogeo = true;
-		}
-	}
-	return gameFound;
+	/* plain names go through the sorted driver index; wildcards still need a scan */
+	if (strpbrk(gameName, "*?") == NULL)
+		drvindex = driver_get_index(gameName);
+	else
+		for (int i = 0; drivers[i]; i++)
+			if ( (drivers[i]->flags & GAME_NO_STANDALONE) == 0 && mame_strwildcmp(gameName, drivers[i]->name) == 0 )
+				drvindex = i;
+
+	if (drvindex < 0 || (drivers[drvindex]->flags & GAME_NO_STANDALONE) != 0)
+		return 0;
+
+	*driverIndex = drvindex;
+	*rotation = drivers[drvindex]->flags & 0x07;
+/*	LOGI("%-18s\"%s\" rot=%i\n", drivers[drvindex]->name, drivers[drvindex]->description, *rotation); */
+	is_neogeo = (strcmp(drivers[drvindex]->source_file, "src/mame/drivers/neogeo/neogeo.inc") == 0);
+	return 1;
 }
 
 static int executeGame(char *path)
@@ -1453,7 +1843,8 @@ static int executeGame(char *path)
 		NULL, NULL, NULL, NULL,
 		NULL, NULL, NULL, NULL,
 		NULL, NULL, NULL, NULL,
-		NULL, NULL, NULL, NULL
+		NULL, NULL, NULL, NULL,
+		NULL, NULL
 	};
 
 	FirstTimeUpdate = 1;
@@ -1468,7 +1859,11 @@ static int executeGame(char *path)
 	}
 
 	// Find the game info. Exit if game driver was not found.
-	if (getGameInfo(MAME_GAME_NAME, &gameRot, &driverIndex) == 0)
+	{
+		startup_trace_scope trace("retro", "getGameInfo");
+		result = getGameInfo(MAME_GAME_NAME, &gameRot, &driverIndex);
+	}
+	if (result == 0)
 	{
 		LOGI("game not found: %s\n", MAME_GAME_NAME);
 		return -2;
@@ -1512,6 +1907,12 @@ static int executeGame(char *path)
 	xargv[paramCount++] = (char *)"-memcard_directory";
 	xargv[paramCount++] = (char *)retro_content_dir;
 
+	if (sound_log)
+	{
+		xargv[paramCount++] = (char *)"-soundlog";
+		xargv[paramCount++] = (char *)sound_log_path;
+	}
+
 	if (!tate)
 	{
 		switch (screenRot)
@@ -17,6 +17,12 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <errno.h>
+#if !defined(WIN32)
+#include <sys/mman.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 
 // MAME headers
 #include "retrofile.h"
@@ -348,6 +354,78 @@ file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 c
 }
 
 
+//============================================================
+//  osd_map
+//============================================================
+
+void *osd_map(osd_file *file, UINT64 offset, UINT32 length)
+{
+#if defined(WIN32)
+	return NULL;
+#else
+	UINT64 pagemask = sysconf(_SC_PAGESIZE) - 1;
+	UINT32 delta = offset & pagemask;
+	void *base;
+
+	if (file->type != SDLFILE_FILE || length == 0)
+		return NULL;
+
+	// private mapping: the page cache is shared until somebody writes
+	base = mmap(NULL, length + delta, PROT_READ | PROT_WRITE, MAP_PRIVATE, file->handle, offset - delta);
+	if (base == MAP_FAILED)
+		return NULL;
+	return (UINT8 *)base + delta;
+#endif
+}
+
+
+//============================================================
+//  osd_unmap
+//============================================================
+
+void osd_unmap(void *base, UINT32 length)
+{
+#if !defined(WIN32)
+	UINT32 delta = (size_t)base & (sysconf(_SC_PAGESIZE) - 1);
+
+	munmap((UINT8 *)base - delta, length + delta);
+#endif
+}
+
+
+//============================================================
+//  osd_open_anonymous
+//============================================================
+
+file_error osd_open_anonymous(osd_file **file)
+{
+#if defined(__linux__) && defined(SYS_memfd_create)
+	int handle;
+
+	*file = (osd_file *) osd_malloc(sizeof(**file));
+	if (*file == NULL)
+		return FILERR_OUT_OF_MEMORY;
+
+	// a memfd is backed by memory, and its pages can be mapped copy-on-write like any file
+	handle = syscall(SYS_memfd_create, "mba-anonymous", 0);
+	if (handle < 0)
+	{
+		osd_free(*file);
+		*file = NULL;
+		return error_to_file_error(errno);
+	}
+
+	(*file)->type = SDLFILE_FILE;
+	(*file)->handle = handle;
+	(*file)->filename[0] = 0;
+	return FILERR_NONE;
+#else
+	*file = NULL;
+	return FILERR_FAILURE;
+#endif
+}
+
+
 //============================================================
 //  osd_close
 //============================================================
@@ -372,6 +372,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = ((char *) result) + sizeof(*result);
 	result->type = S_ISDIR(st.st_mode) ? ENTTYPE_DIR : ENTTYPE_FILE;
 	result->size = (UINT64)st.st_size;
+	result->modified = (UINT64)st.st_mtime;
 
 	return result;
 }
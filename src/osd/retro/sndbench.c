@@ -0,0 +1,871 @@
+/***************************************************************************
+
+    sndbench.c
+
+    Headless replay of sound register logs.
+
+    Usage: sndbench [-samplerate <hz>] [-device <tag>] [-wavwrite <file>]
+                    [-fmrender block|sample] [-compare] <log>
+
+    A log recorded with -soundlog (the core's "sound log" option) holds
+    the sound chips of a session, the regions they read and every write
+    they took. sndbench builds a machine out of just those chips, replays
+    the writes at their original times and reports how fast the chips
+    rendered along with a hash of the mixed output, so a change to a chip
+    or to the streams can be timed and checked against the same input.
+
+    Chips are created with the bench's own interfaces: AY8910 family chips
+    and the SSG of the FM chips use the generic one, so output stage flags
+    set by a driver are not reproduced. Every chip output is mixed at half
+    gain into both speakers.
+
+    The YM2151, YM2203 and YM2610 render a channel at a time over blocks
+    of samples; -fmrender sample selects their original sample-by-sample
+    loops instead. -compare replays the log through both, one after the
+    other, and reports the first sample where they differ; -wavwrite then
+    holds the output of the second (sample-by-sample) run.
+
+****************************************************************************/
+
+#include "osdepend.h"
+#include "emu.h"
+#include "emuopts.h"
+#include "render.h"
+#include "sound/2151intf.h"
+#include "sound/2203intf.h"
+#include "sound/2610intf.h"
+#include "sound/ay8910.h"
+#include "sound/fm.h"
+#include "sound/ics2115.h"
+#include "sound/iremga20.h"
+#include "sound/msm5205.h"
+#include "sound/okim6295.h"
+#include "sound/qsound.h"
+#include "sound/ym2151.h"
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define LOG_MAGIC			"MSNDLOG1"
+#define LOG_END				0xffff
+#define LOG_ENTRY_SIZE		20
+
+#define MAX_CHIPS			16
+#define MAX_REGIONS			64
+
+/* tokens per chip: device add, config, and two routes */
+#define CHIP_TOKENS			(4 * 4)
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef void (*replay_write_func)(running_device *device, int port, UINT32 data);
+
+typedef struct _bench_chip_type bench_chip_type;
+struct _bench_chip_type
+{
+	const char *		name;				/* device name as written to the log */
+	device_type			type;				/* device to create */
+	const void *		config;				/* static config, or NULL for the default */
+	replay_write_func	write;				/* applies one logged write */
+};
+
+typedef struct _log_chip log_chip;
+struct _log_chip
+{
+	const bench_chip_type *type;			/* how to replay it, or NULL if unknown */
+	char				name[256];			/* device name */
+	char				tag[256];			/* device tag */
+	UINT32				clock;				/* device clock */
+	running_device *	device;				/* the device in the bench machine */
+};
+
+typedef struct _log_region log_region;
+struct _log_region
+{
+	char				name[256];			/* region tag */
+	UINT32				flags;				/* region flags */
+	UINT32				length;				/* region length */
+	const UINT8 *		data;				/* contents, within the log */
+};
+
+typedef struct _log_entry log_entry;
+struct _log_entry
+{
+	attotime			time;				/* when the write happened */
+	UINT16				chip;				/* chip index */
+	UINT16				port;				/* port written */
+	UINT32				data;				/* value written */
+};
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+static void replay_ym2151(running_device *device, int port, UINT32 data);
+static void replay_ym2203(running_device *device, int port, UINT32 data);
+static void replay_ym2610(running_device *device, int port, UINT32 data);
+static void replay_qsound(running_device *device, int port, UINT32 data);
+static void replay_ics2115(running_device *device, int port, UINT32 data);
+static void replay_iremga20(running_device *device, int port, UINT32 data);
+static void replay_ay8910(running_device *device, int port, UINT32 data);
+static void replay_okim6295(running_device *device, int port, UINT32 data);
+static void replay_msm5205(running_device *device, int port, UINT32 data);
+static void replay_msm5205_vclk(running_device *device);
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+/* frontend settings the core expects from the OSD; all at their defaults */
+bool verify_rom_hash = false;
+bool verify_rom_zip_crc = false;
+bool cache_decrypted_roms = false;
+bool cache_rom_audit = false;
+bool cache_rom_regions = false;
+bool native_sample_rate = false;
+int stream_resampler = STREAM_RESAMPLER_DEFAULT;
+bool allow_select_newgame = false;
+bool RETRO_LOOP = true;
+
+extern void retro_main_loop(void);
+extern void free_machineconfig(void);
+
+static const ics2115_interface bench_ics2115_interface =
+{
+	NULL
+};
+
+static const msm5205_interface bench_msm5205_interface =
+{
+	replay_msm5205_vclk,	/* the vclk applies writes due by then, as the driver did */
+	MSM5205_S96_4B			/* the log sets the mode the chip was reset to */
+};
+
+static const bench_chip_type chip_types[] =
+{
+	{ "YM2151",		SOUND_YM2151,	NULL,						replay_ym2151 },
+	{ "YM2203",		SOUND_YM2203,	NULL,						replay_ym2203 },
+	{ "YM2610",		SOUND_YM2610,	NULL,						replay_ym2610 },
+	{ "YM2610B",	SOUND_YM2610B,	NULL,						replay_ym2610 },
+	{ "Q-Sound",	SOUND_QSOUND,	NULL,						replay_qsound },
+	{ "ICS2115",	SOUND_ICS2115,	&bench_ics2115_interface,	replay_ics2115 },
+	{ "Irem GA20",	SOUND_IREMGA20,	NULL,						replay_iremga20 },
+	{ "AY-3-8910A",	SOUND_AY8910,	NULL,						replay_ay8910 },
+	{ "AY-3-8912A",	SOUND_AY8912,	NULL,						replay_ay8910 },
+	{ "YM2149",		SOUND_YM2149,	NULL,						replay_ay8910 },
+	{ "OKI6295",	SOUND_OKIM6295,	NULL,						replay_okim6295 },
+	{ "MSM5205",	SOUND_MSM5205,	&bench_msm5205_interface,	replay_msm5205 }
+};
+
+/* the log */
+static UINT8 *logdata;
+static int numchips;
+static log_chip chips[MAX_CHIPS];
+static int numregions;
+static log_region regions[MAX_REGIONS];
+static int numentries;
+static log_entry *entries;
+static attotime endtime;
+
+/* the replay */
+static running_machine *bench_machine;
+static emu_timer *replay_timer;
+static int nextentry;
+static int replay_done;
+static UINT32 samples;
+static UINT64 hash;
+
+/* the mixed output, kept for -compare */
+static int capture;
+static INT16 *pcm;
+static UINT32 pcmalloc;
+
+/* the machine, built from the log */
+static machine_config_token bench_config[4 + MAX_CHIPS * CHIP_TOKENS];
+static rom_entry bench_rom[MAX_REGIONS + 2];
+static game_driver driver_sndbench;
+
+const game_driver * const drivers[] =
+{
+	&driver_sndbench,
+	NULL
+};
+
+
+
+/***************************************************************************
+    CHIP WRITES
+***************************************************************************/
+
+/*-------------------------------------------------
+    replay_xxx - apply one logged write to each
+    kind of chip; ports are those the chips log
+-------------------------------------------------*/
+
+static void replay_ym2151(running_device *device, int port, UINT32 data)
+{
+	ym2151_w(device, port, data);
+}
+
+static void replay_ym2203(running_device *device, int port, UINT32 data)
+{
+	ym2203_w(device, port, data);
+}
+
+static void replay_ym2610(running_device *device, int port, UINT32 data)
+{
+	ym2610_w(device, port, data);
+}
+
+static void replay_qsound(running_device *device, int port, UINT32 data)
+{
+	qsound_w(device, port, data);
+}
+
+static void replay_ics2115(running_device *device, int port, UINT32 data)
+{
+	ics2115_w(device, port, data);
+}
+
+static void replay_iremga20(running_device *device, int port, UINT32 data)
+{
+	irem_ga20_w(device, port, data);
+}
+
+static void replay_ay8910(running_device *device, int port, UINT32 data)
+{
+	ay8910_address_data_w(device, port, data);
+}
+
+static void replay_okim6295(running_device *device, int port, UINT32 data)
+{
+	okim6295_device *oki = downcast<okim6295_device *>(device);
+
+	switch (port)
+	{
+		case OKIM6295_LOG_BANK_BASE:	oki->set_bank_base(data);		break;
+		case OKIM6295_LOG_PIN7:			oki->set_pin7(data);			break;
+		default:						okim6295_w(device, port, data);	break;
+	}
+}
+
+static void replay_msm5205(running_device *device, int port, UINT32 data)
+{
+	switch (port)
+	{
+		case MSM5205_LOG_RESET:			msm5205_reset_w(device, data);		break;
+		case MSM5205_LOG_DATA:			msm5205_data_w(device, data);		break;
+		case MSM5205_LOG_VCLK:			msm5205_vclk_w(device, data);		break;
+		case MSM5205_LOG_PLAYMODE:		msm5205_playmode_w(device, data);	break;
+	}
+}
+
+
+
+/***************************************************************************
+    REPLAY
+***************************************************************************/
+
+/*-------------------------------------------------
+    replay_until - apply every write logged up
+    to the given time
+-------------------------------------------------*/
+
+static void replay_until(attotime time)
+{
+	while (nextentry < numentries && attotime_compare(entries[nextentry].time, time) <= 0)
+	{
+		const log_entry *entry = &entries[nextentry++];
+		const log_chip *chip = &chips[entry->chip];
+
+		if (chip->device != NULL)
+			(*chip->type->write)(chip->device, entry->port, entry->data);
+	}
+}
+
+
+/*-------------------------------------------------
+    replay_callback - apply the writes due now
+    and wait for the next one
+-------------------------------------------------*/
+
+static TIMER_CALLBACK( replay_callback )
+{
+	attotime now = timer_get_time(machine);
+
+	replay_until(now);
+
+	if (nextentry < numentries)
+		timer_adjust_oneshot(replay_timer, attotime_sub(entries[nextentry].time, now), 0);
+	else if (attotime_compare(now, endtime) < 0)
+		timer_adjust_oneshot(replay_timer, attotime_sub(endtime, now), 0);
+	else
+		replay_done = TRUE;
+}
+
+
+/*-------------------------------------------------
+    replay_msm5205_vclk - the MSM5205 takes the
+    next nibble on its own clock; apply what the
+    driver wrote by then before it is decoded
+-------------------------------------------------*/
+
+static void replay_msm5205_vclk(running_device *device)
+{
+	replay_until(timer_get_time(device->machine));
+}
+
+
+
+/***************************************************************************
+    BENCH MACHINE
+***************************************************************************/
+
+/*-------------------------------------------------
+    DRIVER_INIT( sndbench ) - fill the regions
+    with the contents from the log
+-------------------------------------------------*/
+
+static DRIVER_INIT( sndbench )
+{
+	int regnum;
+
+	for (regnum = 0; regnum < numregions; regnum++)
+	{
+		const log_region *region = &regions[regnum];
+		UINT8 *base = memory_region(machine, region->name);
+
+		if (base != NULL)
+			memcpy(base, region->data, MIN(region->length, memory_region_length(machine, region->name)));
+	}
+}
+
+
+/*-------------------------------------------------
+    MACHINE_START( sndbench ) - find the chips
+    and start the replay
+-------------------------------------------------*/
+
+static MACHINE_START( sndbench )
+{
+	int chipnum;
+
+	bench_machine = machine;
+	for (chipnum = 0; chipnum < numchips; chipnum++)
+		if (chips[chipnum].type != NULL)
+			chips[chipnum].device = machine->device(chips[chipnum].tag);
+
+	replay_timer = timer_alloc(machine, replay_callback, NULL);
+	timer_adjust_oneshot(replay_timer, (numentries > 0) ? entries[0].time : attotime_zero, 0);
+}
+
+
+static MACHINE_DRIVER_START( sndbench )
+	MDRV_MACHINE_START(sndbench)
+
+	/* video hardware; the layouts need a screen, and it paces the frames */
+	MDRV_SCREEN_ADD("screen", RASTER)
+	MDRV_SCREEN_FORMAT(BITMAP_FORMAT_RGB32)
+	MDRV_SCREEN_SIZE(16,16)
+	MDRV_SCREEN_VISIBLE_AREA(0,15, 0,15)
+	MDRV_SCREEN_REFRESH_RATE(60)
+
+	/* sound hardware; the chips are added from the log */
+	MDRV_SPEAKER_STANDARD_STEREO("lspeaker", "rspeaker")
+MACHINE_DRIVER_END
+
+
+/*-------------------------------------------------
+    build_driver - describe the chips and the
+    regions of the log as a game; returns the
+    number of chips in it
+-------------------------------------------------*/
+
+static int build_driver(const char *onlytag)
+{
+	static const machine_config_token base[] =
+	{
+		MDRV_IMPORT_FROM(sndbench)
+	};
+	static const machine_config_token end[] =
+	{
+		TOKEN_UINT32_PACK1(MCONFIG_TOKEN_END, 8)
+	};
+	int tokens = 0, roms = 0, devices = 0;
+	int chipnum, regnum;
+
+	memcpy(&bench_config[tokens], base, sizeof(base));
+	tokens += ARRAY_LENGTH(base);
+
+	for (chipnum = 0; chipnum < numchips; chipnum++)
+	{
+		log_chip *chip = &chips[chipnum];
+
+		if (chip->type == NULL || (onlytag != NULL && strcmp(chip->tag, onlytag) != 0))
+		{
+			chip->type = NULL;
+			continue;
+		}
+
+		/* MDRV_DEVICE_CONFIG takes the config itself; ours may be NULL */
+		const machine_config_token device[] =
+		{
+			MDRV_DEVICE_ADD(chip->tag, chip->type->type, chip->clock)
+			TOKEN_UINT32_PACK1(MCONFIG_TOKEN_DEVICE_CONFIG, 8),
+			TOKEN_PTR(voidptr, chip->type->config),
+			MDRV_SOUND_ROUTE(ALL_OUTPUTS, "lspeaker", 0.5)
+			MDRV_SOUND_ROUTE(ALL_OUTPUTS, "rspeaker", 0.5)
+		};
+		memcpy(&bench_config[tokens], device, sizeof(device));
+		tokens += ARRAY_LENGTH(device);
+		devices++;
+
+		/* the regions have no files; they are erased and filled in by DRIVER_INIT */
+		for (regnum = 0; regnum < numregions; regnum++)
+		{
+			const log_region *region = &regions[regnum];
+			int taglen = strlen(chip->tag);
+
+			if (strncmp(region->name, chip->tag, taglen) == 0 && (region->name[taglen] == 0 || region->name[taglen] == '.'))
+			{
+				rom_entry *rom = &bench_rom[roms++];
+
+				rom->_name = region->name;
+				rom->_length = region->length;
+				rom->_flags = ROMENTRYTYPE_REGION | ROMREGION_ERASE | (region->flags & ~ROMENTRY_TYPEMASK);
+			}
+		}
+	}
+	memcpy(&bench_config[tokens], end, sizeof(end));
+
+	/* the core expects a game to have at least one region */
+	if (roms == 0)
+	{
+		bench_rom[roms]._name = "sndbench";
+		bench_rom[roms]._length = 1;
+		bench_rom[roms++]._flags = ROMENTRYTYPE_REGION | ROMREGION_ERASE;
+	}
+	bench_rom[roms]._flags = ROMENTRYTYPE_END;
+
+	driver_sndbench.source_file = __FILE__;
+	driver_sndbench.parent = "0";
+	driver_sndbench.name = "sndbench";
+	driver_sndbench.description = "Sound register log replay";
+	driver_sndbench.year = "????";
+	driver_sndbench.manufacturer = "MAME";
+	driver_sndbench.machine_config = bench_config;
+	driver_sndbench.driver_init = DRIVER_INIT_NAME(sndbench);
+	driver_sndbench.rom = bench_rom;
+	driver_sndbench.flags = ROT0;
+	return devices;
+}
+
+
+
+/***************************************************************************
+    LOG READING
+***************************************************************************/
+
+/*-------------------------------------------------
+    log_get - take bytes from the log, or return
+    NULL if it is too short
+-------------------------------------------------*/
+
+static const UINT8 *log_get(UINT32 *offset, UINT32 length, UINT32 loglength)
+{
+	const UINT8 *result = &logdata[*offset];
+
+	if (length > loglength - *offset)
+		return NULL;
+	*offset += length;
+	return result;
+}
+
+
+/*-------------------------------------------------
+    log_get32/log_get_string - take a value or a
+    string from the log
+-------------------------------------------------*/
+
+static int log_get32(UINT32 *offset, UINT32 loglength, UINT32 *value)
+{
+	const UINT8 *bytes = log_get(offset, 4, loglength);
+
+	if (bytes == NULL)
+		return FALSE;
+	*value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24);
+	return TRUE;
+}
+
+static int log_get_string(UINT32 *offset, UINT32 loglength, char *string)
+{
+	const UINT8 *length = log_get(offset, 1, loglength);
+	const UINT8 *chars;
+
+	if (length == NULL || (chars = log_get(offset, *length, loglength)) == NULL)
+		return FALSE;
+	memcpy(string, chars, *length);
+	string[*length] = 0;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    read_log - load a register log and sort out
+    its chips, regions and writes
+-------------------------------------------------*/
+
+static int read_log(const char *filename)
+{
+	core_file *file;
+	UINT32 loglength, offset = 0;
+	UINT32 count, value;
+	int chipnum, regnum;
+
+	if (core_fopen(filename, OPEN_FLAG_READ, &file) != FILERR_NONE)
+	{
+		fprintf(stderr, "Unable to open %s\n", filename);
+		return FALSE;
+	}
+	loglength = core_fsize(file);
+	logdata = (UINT8 *)malloc(loglength);
+	loglength = core_fread(file, logdata, loglength);
+	core_fclose(file);
+
+	if (loglength < 8 || memcmp(logdata, LOG_MAGIC, 8) != 0)
+	{
+		fprintf(stderr, "%s is not a sound register log\n", filename);
+		return FALSE;
+	}
+	offset = 8;
+
+	/* chips and their regions */
+	if (!log_get32(&offset, loglength, &count) || count > MAX_CHIPS)
+		goto truncated;
+	for (chipnum = 0; chipnum < (int)count; chipnum++)
+	{
+		log_chip *chip = &chips[numchips++];
+		int typenum;
+
+		if (!log_get_string(&offset, loglength, chip->name) || !log_get_string(&offset, loglength, chip->tag) ||
+			!log_get32(&offset, loglength, &chip->clock) || !log_get32(&offset, loglength, &value))
+			goto truncated;
+
+		for (typenum = 0; typenum < ARRAY_LENGTH(chip_types); typenum++)
+			if (strcmp(chip->name, chip_types[typenum].name) == 0)
+				chip->type = &chip_types[typenum];
+		if (chip->type == NULL)
+			fprintf(stderr, "No replay for %s '%s'; its writes are skipped\n", chip->name, chip->tag);
+
+		for (regnum = 0; regnum < (int)value; regnum++)
+		{
+			log_region *region = &regions[numregions];
+
+			if (numregions++ == MAX_REGIONS || !log_get_string(&offset, loglength, region->name) ||
+				!log_get32(&offset, loglength, &region->flags) || !log_get32(&offset, loglength, &region->length) ||
+				(region->data = log_get(&offset, region->length, loglength)) == NULL)
+				goto truncated;
+		}
+	}
+
+	/* the writes; a log whose session was not closed has no end marker and
+       ends with its last write */
+	entries = (log_entry *)malloc(((loglength - offset) / LOG_ENTRY_SIZE) * sizeof(*entries));
+	while (loglength - offset >= LOG_ENTRY_SIZE)
+	{
+		log_entry *entry = &entries[numentries];
+		UINT32 seconds, attolo, attohi;
+
+		log_get32(&offset, loglength, &seconds);
+		log_get32(&offset, loglength, &attolo);
+		log_get32(&offset, loglength, &attohi);
+		log_get32(&offset, loglength, &value);
+		entry->time.seconds = seconds;
+		entry->time.attoseconds = ((UINT64)attohi << 32) | attolo;
+		entry->chip = value >> 16;
+		entry->port = value & 0xffff;
+		log_get32(&offset, loglength, &entry->data);
+
+		endtime = entry->time;
+		if (entry->chip == LOG_END)
+			break;
+		if (entry->chip >= numchips)
+			goto truncated;
+		numentries++;
+	}
+	return TRUE;
+
+truncated:
+	fprintf(stderr, "%s is damaged\n", filename);
+	return FALSE;
+}
+
+
+
+/***************************************************************************
+    OSD INTERFACE
+***************************************************************************/
+
+/*-------------------------------------------------
+    osd_update - end each call into the core
+    after a frame
+-------------------------------------------------*/
+
+void osd_update(running_machine *machine, int skip_redraw)
+{
+	RETRO_LOOP = false;
+}
+
+
+/*-------------------------------------------------
+    osd_update_audio_stream - count and hash the
+    mixed output (FNV-1a over the samples), and
+    keep it if it is to be compared
+-------------------------------------------------*/
+
+void osd_update_audio_stream(running_machine *machine, INT16 *buffer, int samples_this_frame)
+{
+	int sampnum;
+
+	for (sampnum = 0; sampnum < samples_this_frame * 2; sampnum++)
+	{
+		hash = (hash ^ (UINT8)buffer[sampnum]) * U64(0x100000001b3);
+		hash = (hash ^ (UINT8)(buffer[sampnum] >> 8)) * U64(0x100000001b3);
+	}
+
+	if (capture)
+	{
+		/* realloc is off limits in the core; grow it by hand */
+		if ((samples + samples_this_frame) * 2 > pcmalloc)
+		{
+			INT16 *grown;
+
+			pcmalloc = MAX(pcmalloc * 2, (samples + samples_this_frame) * 2);
+			grown = (INT16 *)malloc(pcmalloc * sizeof(*pcm));
+			if (pcm != NULL)
+				memcpy(grown, pcm, samples * 2 * sizeof(*pcm));
+			free(pcm);
+			pcm = grown;
+		}
+		memcpy(&pcm[samples * 2], buffer, samples_this_frame * 2 * sizeof(*pcm));
+	}
+	samples += samples_this_frame;
+}
+
+
+/*-------------------------------------------------
+    osd_init - give the UI a target to draw its
+    messages into; nothing displays it
+-------------------------------------------------*/
+
+void osd_init(running_machine *machine)
+{
+	render_target_alloc(machine, NULL, 0);
+}
+
+
+/*-------------------------------------------------
+    no input, volume or debugger in the bench
+-------------------------------------------------*/
+
+void osd_set_mastervolume(int attenuation)
+{
+}
+
+void osd_customize_input_type_list(input_type_desc *typelist)
+{
+}
+
+void osd_wait_for_debugger(running_device *device, int firststop)
+{
+}
+
+void osd_break_into_debugger(const char *message)
+{
+}
+
+
+
+/***************************************************************************
+    MAIN
+***************************************************************************/
+
+/*-------------------------------------------------
+    run_replay - play the log out through a fresh
+    machine; returns the time it took, or 0 if
+    the machine did not start
+-------------------------------------------------*/
+
+static osd_ticks_t run_replay(core_options *options)
+{
+	osd_ticks_t ticks;
+	int chipnum;
+
+	nextentry = 0;
+	replay_done = FALSE;
+	samples = 0;
+	hash = U64(0xcbf29ce484222325);
+	for (chipnum = 0; chipnum < numchips; chipnum++)
+		chips[chipnum].device = NULL;
+
+	/* the machine starts in mame_execute; run it frame by frame until the
+       log is played out */
+	ticks = osd_ticks();
+	if (mame_execute(options) != 1)
+		return 0;
+	while (!replay_done)
+	{
+		RETRO_LOOP = true;
+		retro_main_loop();
+	}
+	ticks = osd_ticks() - ticks;
+
+	/* exit notifiers close the WAV file; nothing else is saved */
+	bench_machine->call_notifiers(MACHINE_NOTIFY_EXIT);
+	free_machineconfig();
+	return MAX(ticks, 1);
+}
+
+
+/*-------------------------------------------------
+    report - print the speed and the hash of a run
+-------------------------------------------------*/
+
+static void report(const char *label, osd_ticks_t ticks)
+{
+	double seconds = (double)ticks / (double)osd_ticks_per_second();
+	double played = attotime_to_double(endtime);
+
+	printf("%s%u samples in %.3f seconds: %.0f samples/sec (%.1fx realtime)\n", label, samples, seconds, samples / seconds, played / seconds);
+	printf("%shash %08x%08x\n", label, (UINT32)(hash >> 32), (UINT32)hash);
+}
+
+
+/*-------------------------------------------------
+    set_fm_render - pick the block or the sample
+    by sample loops of the FM chips
+-------------------------------------------------*/
+
+static void set_fm_render(int block)
+{
+	fm_block_render = block;
+	ym2151_block_render = block;
+}
+
+
+int main(int argc, char *argv[])
+{
+	const char *logname = NULL, *onlytag = NULL, *wavname = NULL;
+	int samplerate = 48000, block = TRUE, compare = FALSE, result = 0;
+	core_options *options;
+	osd_ticks_t ticks;
+	int argnum;
+
+	for (argnum = 1; argnum < argc; argnum++)
+	{
+		if (strcmp(argv[argnum], "-samplerate") == 0 && argnum + 1 < argc)
+			samplerate = atoi(argv[++argnum]);
+		else if (strcmp(argv[argnum], "-device") == 0 && argnum + 1 < argc)
+			onlytag = argv[++argnum];
+		else if (strcmp(argv[argnum], "-wavwrite") == 0 && argnum + 1 < argc)
+			wavname = argv[++argnum];
+		else if (strcmp(argv[argnum], "-fmrender") == 0 && argnum + 1 < argc && (strcmp(argv[argnum + 1], "block") == 0 || strcmp(argv[argnum + 1], "sample") == 0))
+			block = (strcmp(argv[++argnum], "block") == 0);
+		else if (strcmp(argv[argnum], "-compare") == 0)
+			compare = TRUE;
+		else if (argv[argnum][0] != '-' && logname == NULL)
+			logname = argv[argnum];
+		else
+			logname = NULL, argnum = argc;
+	}
+	if (logname == NULL || samplerate <= 0)
+	{
+		fprintf(stderr, "Usage: %s [-samplerate <hz>] [-device <tag>] [-wavwrite <file>] [-fmrender block|sample] [-compare] <log>\n", argv[0]);
+		return 1;
+	}
+
+	if (!read_log(logname))
+		return 1;
+	if (build_driver(onlytag) == 0)
+	{
+		fprintf(stderr, "No chip to replay in %s\n", logname);
+		return 1;
+	}
+
+	options = mame_options_init(NULL);
+	options_set_string(options, OPTION_GAMENAME, driver_sndbench.name, OPTION_PRIORITY_CMDLINE);
+	options_set_int(options, OPTION_SAMPLERATE, samplerate, OPTION_PRIORITY_CMDLINE);
+	options_set_bool(options, OPTION_READCONFIG, FALSE, OPTION_PRIORITY_CMDLINE);
+	options_set_bool(options, OPTION_THROTTLE, FALSE, OPTION_PRIORITY_CMDLINE);
+	options_set_bool(options, OPTION_SKIP_WARNINGS, TRUE, OPTION_PRIORITY_CMDLINE);
+	if (wavname != NULL)
+		options_set_string(options, OPTION_WAVWRITE, wavname, OPTION_PRIORITY_CMDLINE);
+
+	if (!compare)
+	{
+		set_fm_render(block);
+		ticks = run_replay(options);
+		if (ticks == 0)
+			return 1;
+		printf("%d chips, %d writes, %.3f seconds\n", numchips, numentries, attotime_to_double(endtime));
+		report("", ticks);
+	}
+	else
+	{
+		INT16 *blockpcm;
+		UINT32 blocksamples, sampnum;
+
+		/* block rendering first, keeping its output aside */
+		capture = TRUE;
+		set_fm_render(TRUE);
+		ticks = run_replay(options);
+		if (ticks == 0)
+			return 1;
+		printf("%d chips, %d writes, %.3f seconds\n", numchips, numentries, attotime_to_double(endtime));
+		report("block:  ", ticks);
+		blockpcm = pcm;
+		blocksamples = samples;
+		pcm = NULL;
+		pcmalloc = 0;
+
+		/* then the original loops over the same writes */
+		set_fm_render(FALSE);
+		ticks = run_replay(options);
+		if (ticks == 0)
+			return 1;
+		report("sample: ", ticks);
+
+		for (sampnum = 0; sampnum < MIN(samples, blocksamples) * 2; sampnum++)
+			if (blockpcm[sampnum] != pcm[sampnum])
+				break;
+		if (sampnum < MIN(samples, blocksamples) * 2)
+		{
+			printf("outputs differ at sample %u (%s): %d block, %d sample\n", sampnum / 2, (sampnum & 1) ? "right" : "left", blockpcm[sampnum], pcm[sampnum]);
+			result = 1;
+		}
+		else if (samples != blocksamples)
+		{
+			printf("outputs differ in length: %u samples block, %u sample\n", blocksamples, samples);
+			result = 1;
+		}
+		else
+			printf("outputs identical\n");
+		free(blockpcm);
+		free(pcm);
+	}
+	options_free(options);
+
+	free(entries);
+	free(logdata);
+	return result;
+}